@@ -30,9 +30,11 @@
  * up to measure using the maximum conversion length (and maximum accuracy) and then average those
  * readings 64 times. This results in readings taking 8.244ms x 64 = 527.616ms or just less than 2
  * times a second. The pin-change interrupt handler is called when a reading is finished and the
- * INA226 pulls the pin down to ground, it resets the pin status and adds the readings to the global
- * variables. The main program will do whatever processing it has to and every 5 seconds it will
- * display the current averaged readings and reset them.\n
+ * INA226 pulls the pin down to ground. No I2C calls are made from the interrupt handler, it only
+ * tells the library's acquisition engine that the ALERT line went low by calling
+ * "alertInterrupt()". The engine is advanced by calling "poll()" from the main loop, which reads
+ * the device and stores the sample for "getSample()". The main program will do whatever processing
+ * it has to and after every 10 readings it will display the averaged readings and reset them.\n
  *
  * The datasheet for the INA226 can be found at http://www.ti.com/lit/ds/symlink/INA226.pdf and it
  * contains the information required in order to hook up the device. Unfortunately it comes as a
@@ -63,6 +65,7 @@
  *
  * Version | Date       | Developer   | Comments
  * ------- | ---------- | ----------- | ------------------------------------------------------------
+ * 1.0.6   | 2026-10-14 | agent       | Use the acquisition engine instead of I2C calls in the ISR
  * 1.0.5   | 2020-12-01 | SV-Zanshin  | Corrected "alertOnConversion()" call
  * 1.0.4   | 2019-02-16 | SV-Zanshin  | ifdef so that sketch won't compile on incompatible platforms
  * 1.0.3   | 2019-01-09 | SV-Zanshin  | Cleaned up doxygen formatting
@@ -91,29 +94,18 @@ const uint32_t SERIAL_SPEED  = 115200;  ///< Use fast serial speed
 ** Declare global variables and instantiate classes                                              **
 **************************************************************************************************/
 INA_Class         INA;                          ///< INA class instantiation
-volatile uint8_t  deviceNumber    = UINT8_MAX;  ///< Device Number to use in example
-volatile uint64_t sumBusMillVolts = 0;          ///< Sum of bus voltage readings
-volatile int64_t  sumBusMicroAmps = 0;          ///< Sum of bus amperage readings
-volatile uint8_t  readings        = 0;          ///< Number of measurements taken
+uint8_t           deviceNumber    = UINT8_MAX;  ///< Device Number to use in example
+uint64_t          sumBusMillVolts = 0;          ///< Sum of bus voltage readings
+int64_t           sumBusMicroAmps = 0;          ///< Sum of bus amperage readings
+uint8_t           readings        = 0;          ///< Number of measurements taken
 
 ISR(PCINT0_vect) {
   /*!
     @brief Interrupt service routine for the PCINT0_vect
-    @details Routine is called whenever the INA_ALERT_PIN changes value
+    @details Routine is called whenever the INA_ALERT_PIN changes value. Only a falling edge is of
+             interest, and the actual reading of the device is left to "INA.poll()" in the main loop
   */
-  *digitalPinToPCMSK(INA_ALERT_PIN) &= ~bit(digitalPinToPCMSKbit(INA_ALERT_PIN));  // Disable PCMSK
-  PCICR &= ~bit(digitalPinToPCICRbit(INA_ALERT_PIN));        // disable interrupt for the group
-  sei();                                                     // Enable interrupts (for I2C calls)
-  digitalWrite(GREEN_LED_PIN, !digitalRead(GREEN_LED_PIN));  // Toggle LED
-  sumBusMillVolts += INA.getBusMilliVolts(deviceNumber);     // Add current value to sum
-  sumBusMicroAmps += INA.getBusMicroAmps(deviceNumber);      // Add current value to sum
-  readings++;
-  INA.waitForConversion(deviceNumber);  // Wait for conversion & INA int. flag
-  cli();                                // Disable interrupts
-  *digitalPinToPCMSK(INA_ALERT_PIN) |=
-      bit(digitalPinToPCMSKbit(INA_ALERT_PIN));       // Enable PCMSK pin
-  PCIFR |= bit(digitalPinToPCICRbit(INA_ALERT_PIN));  // clear any outstanding interrupt
-  PCICR |= bit(digitalPinToPCICRbit(INA_ALERT_PIN));  // enable interrupt for the group
+  if (!digitalRead(INA_ALERT_PIN)) INA.alertInterrupt();  // Tell library that ALERT went low
 }  // of ISR handler for INT0 group of pins
 
 /*!
@@ -134,7 +126,7 @@ void setup() {
 #ifdef __AVR_ATmega32U4__  // If this is a 32U4 processor, wait 2 seconds for initialization
   delay(2000);
 #endif
-  Serial.print(F("\n\nBackground INA Read V1.0.5\n"));
+  Serial.print(F("\n\nBackground INA Read V1.0.6\n"));
   uint8_t devicesFound = 0;
   while (deviceNumber == UINT8_MAX)  // Loop until we find the first device
   {
@@ -160,20 +152,28 @@ void setup() {
   INA.setBusConversion(8244, deviceNumber);             // Maximum conversion time 8.244ms
   INA.setShuntConversion(8244, deviceNumber);           // Maximum conversion time 8.244ms
   INA.setMode(INA_MODE_CONTINUOUS_BOTH, deviceNumber);  // Bus/shunt measured continuously
-  INA.alertOnConversion(true, deviceNumber);            // Make alert pin go low on finish
+  INA.startAcquisition(true);                           // Read in background using ALERT pin
 }  // of method setup()
 
 void loop() {
   /*!
    @brief    Arduino method for the main program loop
    @details  This is the main program for the Arduino IDE, it is called in an infinite loop. The
-             INA226 measurements are triggered by the interrupt handler each time a conversion is
-             ready and stored in variables. The main program doesn't call any INA library functions,
-             that is done in the interrupt handler. Each time 10 readings have been collected the
-             program will output the averaged values and measurements resume from that point onwards
+             interrupt handler signals the library each time a conversion is ready, and the call to
+             "poll()" then reads the device without waiting. Each time 10 readings have been
+             collected the program will output the averaged values and measurements resume from
+             that point onwards
    @return   void
   */
   static long lastMillis = millis();  // Store the last time we printed something
+  inaReading  reading;                // Converted values of one sample
+  INA.poll();                         // Read the device if the ALERT line went low
+  if (INA.getSample(deviceNumber, reading)) {
+    digitalWrite(GREEN_LED_PIN, !digitalRead(GREEN_LED_PIN));  // Toggle LED
+    sumBusMillVolts += reading.busMilliVolts;                  // Add current value to sum
+    sumBusMicroAmps += reading.busMicroAmps;                   // Add current value to sum
+    readings++;
+  }  // of if-then a new sample is available
   if (readings >= 10) {
     Serial.print(F("Averaging readings taken over "));
     Serial.print((float)(millis() - lastMillis) / 1000, 2);
@@ -182,11 +182,9 @@ void loop() {
     Serial.print(F("V\nBus amperage:  "));
     Serial.print((float)sumBusMicroAmps / readings / 1000.0, 4);
     Serial.print(F("mA\n\n"));
-    lastMillis = millis();
-    cli();  // Disable interrupts to reset values
+    lastMillis      = millis();
     readings        = 0;
     sumBusMillVolts = 0;
     sumBusMicroAmps = 0;
-    sei();  // Enable interrupts again
-  }         // of if-then we've reached the required amount of readings
+  }  // of if-then we've reached the required amount of readings
 }  // of method loop()
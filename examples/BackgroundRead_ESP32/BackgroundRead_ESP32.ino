@@ -29,10 +29,14 @@
  * information is returned using 32-bit integers the precision remains the same.\n The INA226 is set
  * up to measure using the maximum conversion length (and maximum accuracy) and then average those
  * readings 64 times. This results in readings taking 8.244ms x 64 = 527.616ms or just less than 2
- * times a second. The pin-change interrupt handler is called when a reading is finished and the
- * INA226 pulls the pin down to ground, it resets the pin status and adds the readings to the global
- * variables. The main program will do whatever processing it has to and every 5 seconds it will
- * display the current averaged readings and reset them.\n
+ * times a second. The readings are taken by the library's sampling task "startTask()", which runs
+ * pinned to core 0 while the Arduino "loop()" runs on core 1. When a reading is finished the INA226
+ * pulls the ALERT pin down to ground, the interrupt handler of the pin only wakes the task, which
+ * then reads the device and pushes the sample into a ring buffer. No I2C calls are made from the
+ * interrupt handler. The main program takes the samples from the ring buffer without any locking
+ * and after every 10 readings it will display the averaged readings and reset them. Any other
+ * library call made while the task is running needs to be enclosed in "INA.lock()" and
+ * "INA.unlock()", as shown when displaying the device's bus voltage directly.\n
  *
  * The datasheet for the INA226 can be found at http://www.ti.com/lit/ds/symlink/INA226.pdf and it
  * contains the information required in order to hook up the device. Unfortunately it comes as a
@@ -64,6 +68,7 @@
  *
  * Version | Date       | Developer   | Comments
  * ------- | ---------- | ----------- | --------
+ * 1.1.0   | 2026-10-14 | agent       | Read in the library's sampling task instead of the ISR
  * 1.0.3   | 2020-12-02 | SV-Zanshin  | Corrected call to "AlertOnConversion()"
  * 1.0.2   | 2020-06-30 | SV-Zanshin  | Issue #58 - clang-formatted document
  * 1.0.1   | 2020-03-24 | SV-Zanshin  | Issue #53 - Doxygen documentation
@@ -82,29 +87,14 @@
 /**************************************************************************************************
 ** Declare program Constants, global variables and instantiate classes                           **
 **************************************************************************************************/
-INA_Class         INA;                          ///< INA class instantiation
-const uint8_t     INA_ALERT_PIN   = A0;         ///< Pin-Change used for INA "ALERT" functionality
-const uint32_t    SERIAL_SPEED    = 115200;     ///< Use fast serial speed
-volatile uint8_t  deviceNumber    = UINT8_MAX;  ///< Device Number to use in example
-volatile uint64_t sumBusMillVolts = 0;          ///< Sum of bus voltage readings
-volatile int64_t  sumBusMicroAmps = 0;          ///< Sum of bus amperage readings
-volatile uint8_t  readings        = 0;          ///< Number of measurements taken
-portMUX_TYPE      mux             = portMUX_INITIALIZER_UNLOCKED;  ///< Synchronization variable
-
-void IRAM_ATTR InterruptHandler() {
-  /*!
-    @brief Interrupt service routine for the INA pin
-    @details Routine is called whenever the INA_ALERT_PIN changes value
-  */
-  portENTER_CRITICAL_ISR(&mux);
-  sei();                                                  // Enable interrupts (for I2C calls)
-  sumBusMillVolts += INA.getBusMilliVolts(deviceNumber);  // Add current value to sum
-  sumBusMicroAmps += INA.getBusMicroAmps(deviceNumber);   // Add current value to sum
-  readings++;
-  INA.waitForConversion(deviceNumber);  // Wait for conv and reset interrupt
-  cli();                                // Disable interrupts
-  portEXIT_CRITICAL_ISR(&mux);
-}  // of ISR for handling interrupts
+INA_Class          INA;                          ///< INA class instantiation
+INA_RingBuffer<16> sampleRing;                   ///< Samples queued by the library's sampling task
+const uint8_t      INA_ALERT_PIN   = A0;         ///< Pin-Change used for INA "ALERT" functionality
+const uint32_t     SERIAL_SPEED    = 115200;     ///< Use fast serial speed
+uint8_t            deviceNumber    = UINT8_MAX;  ///< Device Number to use in example
+uint64_t           sumBusMillVolts = 0;          ///< Sum of bus voltage readings
+int64_t            sumBusMicroAmps = 0;          ///< Sum of bus amperage readings
+uint8_t            readings        = 0;          ///< Number of measurements taken
 
 void setup() {
   /*!
@@ -114,10 +104,8 @@ void setup() {
              never returns
    @return   void
   */
-  pinMode(INA_ALERT_PIN, INPUT_PULLUP);
-  attachInterrupt(digitalPinToInterrupt(INA_ALERT_PIN), InterruptHandler, FALLING);
   Serial.begin(SERIAL_SPEED);
-  Serial.print(F("\n\nBackground INA Read V1.0.1\n"));
+  Serial.print(F("\n\nBackground INA Read V1.1.0\n"));
   uint8_t devicesFound = 0;
   while (deviceNumber == UINT8_MAX)  // Loop until we find the first device
   {
@@ -144,20 +132,29 @@ void setup() {
   INA.setBusConversion(8244, deviceNumber);             // Maximum conversion time 8.244ms
   INA.setShuntConversion(8244, deviceNumber);           // Maximum conversion time 8.244ms
   INA.setMode(INA_MODE_CONTINUOUS_BOTH, deviceNumber);  // Bus/shunt measured continuously
-  INA.alertOnConversion(true, deviceNumber);            // Make alert pin go low on finish
+  INA.startTask(sampleRing, INA_ALERT_PIN);             // Read in a task woken by the ALERT pin
 }  // of method setup()
 
 void loop() {
   /*!
    @brief    Arduino method for the main program loop
    @details  This is the main program for the Arduino IDE, it is called in an infinite loop. The
-             INA226 measurements are triggered by the interrupt handler each time a conversion is
-             ready and stored in variables. The main program doesn't call any INA library functions,
-             that is done in the interrupt handler. Each time 10 readings have been collected the
-             program will output the averaged values and measurements resume from that point onwards
+             INA226 measurements are read by the sampling task each time a conversion is ready and
+             queued in the ring buffer, from where they are taken here. Each time 10 readings have
+             been collected the program will output the averaged values and measurements resume
+             from that point onwards
    @return   void
   */
-  static long lastMillis = millis();  // Store the last time we printed something
+  static long  lastMillis = millis();  // Store the last time we printed something
+  inaRawSample sample;                 // One raw sample from the ring buffer
+  inaReading   reading;                // and its converted values
+  while (sampleRing.pop(sample)) {
+    if (sample.deviceNumber != deviceNumber) continue;  // Only use the selected device
+    INA.convertSample(sample, reading);                 // Conversion doesn't use the I2C bus
+    sumBusMillVolts += reading.busMilliVolts;           // Add current value to sum
+    sumBusMicroAmps += reading.busMicroAmps;            // Add current value to sum
+    readings++;
+  }  // of while samples are queued
   if (readings >= 10) {
     Serial.print(F("Averaging readings taken over "));
     Serial.print((float)(millis() - lastMillis) / 1000, 2);
@@ -165,12 +162,14 @@ void loop() {
     Serial.print((float)sumBusMillVolts / readings / 1000.0, 4);
     Serial.print(F("V\nBus amperage:  "));
     Serial.print((float)sumBusMicroAmps / readings / 1000.0, 4);
-    Serial.print(F("mA\n\n"));
-    lastMillis = millis();
-    cli();  // Disable interrupts to reset values
+    Serial.print(F("mA\nDirect read:   "));
+    INA.lock();  // Keep the sampling task off the bus during the call
+    Serial.print(INA.getBusMilliVolts(deviceNumber) / 1000.0, 4);
+    INA.unlock();
+    Serial.print(F("V\n\n"));
+    lastMillis      = millis();
     readings        = 0;
     sumBusMillVolts = 0;
     sumBusMicroAmps = 0;
-    sei();  // Enable interrupts again
-  }         // of if-then we've reached the required amount of readings
+  }  // of if-then we've reached the required amount of readings
 }  // of method loop()
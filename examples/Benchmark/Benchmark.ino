@@ -0,0 +1,251 @@
+/*!
+ @file Benchmark.ino
+
+ @brief Example program for the INA Library measuring the cost of the library calls
+
+ @section Benchmark_section Description
+
+ Program to measure what the INA library costs on the board it runs on. For each of the standard,
+ fast and fast-plus I2C speeds it times every getter, the "readAll()" snapshot read and the
+ acquisition engine in triggered, continuous and asynchronous mode, using the first device found.
+ The results are shown as microseconds per call and as calls or samples per second.\n\n
+
+ The devices are set to their shortest conversion times and no averaging, so that the sample rates
+ show what the I2C bus and the library can do rather than what the conversion times allow.\n\n
+
+ If the library is compiled with INA_COUNTERS set to 1 (in "INA.h" or as a compiler flag) then the
+ I2C transactions, bytes, I2C delay time, EEPROM record reads and cache hits per call are shown as
+ well, which shows where the time goes. Boards whose I2C hardware cannot run at 1MHz will run the
+ fast-plus tests at their own highest speed.\n\n
+
+ Detailed documentation can be found on the GitHub Wiki pages at
+ https://github.com/Zanduino/INA/wiki
+
+ @section Benchmark_license GNU General Public License v3.0
+
+ This program is free software : you can redistribute it and/or modify it under the terms of the
+ GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ License, or (at your option) any later version.This program is distributed in the hope that it
+ will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.You should
+ have received a copy of the GNU General Public License along with this program(see
+ https://github.com/Zanduino/INA/blob/master/LICENSE).  If not, see
+ <http://www.gnu.org/licenses/>.
+
+ @section Benchmark_author Author
+
+ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+ @section Benchmark_versions Changelog
+
+ | Version | Date       | Developer  | Comments                                                    |
+ | ------- | ---------- | -----------| ----------------------------------------------------------- |
+ | 1.0.1   | 2026-10-14 | agent      | Added asynchronous acquisition                              |
+ | 1.0.0   | 2026-10-14 | agent      | Initial coding                                              |
+*/
+
+#if ARDUINO >= 100  // Arduino IDE versions before 100 need to use the older library
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include <INA.h>  // Zanshin INA Library
+
+/**************************************************************************************************
+** Declare program constants, global variables and instantiate INA class                         **
+**************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};     ///< Use fast serial speed
+const uint32_t SHUNT_MICRO_OHM{100000};  ///< Shunt resistance in Micro-Ohm, e.g. 100000 is 0.1 Ohm
+const uint16_t MAXIMUM_AMPS{1};          ///< Max expected amps, clamped from 1A to a max of 1022A
+const uint16_t BENCHMARK_CALLS{200};     ///< Number of calls timed per getter
+const uint16_t BENCHMARK_MILLIS{1000};   ///< Milliseconds each acquisition mode is run for
+const uint8_t  MAX_READINGS{4};          ///< Devices read by the "readAll()" test
+const uint32_t I2C_SPEEDS[]{INA_I2C_STANDARD_MODE, INA_I2C_FAST_MODE,
+                            INA_I2C_FAST_MODE_PLUS};  ///< I2C speeds to benchmark
+/*! Enumerated list of the timed library calls */
+enum benchmarkTest {
+  TEST_BUS_MILLIVOLTS,    ///< getBusMilliVolts()
+  TEST_SHUNT_MICROVOLTS,  ///< getShuntMicroVolts()
+  TEST_BUS_MICROAMPS,     ///< getBusMicroAmps()
+  TEST_BUS_MICROWATTS,    ///< getBusMicroWatts()
+  TEST_BUS_RAW,           ///< getBusRaw()
+  TEST_READ_ALL,          ///< readAll()
+  TEST_COUNT              ///< Number of tests
+};                        // of enumerated type
+uint8_t          devicesFound{0};  ///< Number of INAs found
+volatile int64_t sink{0};          ///< Results are added here so the calls can't be optimized away
+INA_Class        INA;              ///< INA class instantiation to use EEPROM
+
+void printTestName(const uint8_t test) {
+  /*!
+   * @brief    Print the name of a timed library call, padded to a fixed width
+   * @param[in] test Test from the "benchmarkTest" enumerated list
+   * @return   void
+   */
+  switch (test) {
+    case TEST_BUS_MILLIVOLTS: Serial.print(F("getBusMilliVolts()   ")); break;
+    case TEST_SHUNT_MICROVOLTS: Serial.print(F("getShuntMicroVolts() ")); break;
+    case TEST_BUS_MICROAMPS: Serial.print(F("getBusMicroAmps()    ")); break;
+    case TEST_BUS_MICROWATTS: Serial.print(F("getBusMicroWatts()   ")); break;
+    case TEST_BUS_RAW: Serial.print(F("getBusRaw()          ")); break;
+    case TEST_READ_ALL: Serial.print(F("readAll()            ")); break;
+  }  // of switch test
+}  // of method printTestName()
+
+void printRate(const uint32_t elapsedMicros, const uint32_t count) {
+  /*!
+   * @brief    Print the time per call with one decimal and the resulting calls per second
+   * @param[in] elapsedMicros Microseconds taken by all calls
+   * @param[in] count Number of calls made
+   * @return   void
+   */
+  if (count == 0) {
+    Serial.print(F("       -           - /s"));
+    return;
+  }  // of if-then nothing measured
+  uint32_t tenths = (uint64_t)elapsedMicros * 10 / count;
+  Serial.print(tenths / 10);
+  Serial.print('.');
+  Serial.print(tenths % 10);
+  Serial.print(F("us "));
+  Serial.print((uint32_t)((uint64_t)count * 1000000 / elapsedMicros));
+  Serial.print(F("/s"));
+}  // of method printRate()
+
+void printCounters(const uint32_t calls) {
+  /*!
+   * @brief    Print the library traffic counters per call, when the library keeps them
+   * @param[in] calls Number of calls the counters were collected over
+   * @return   void
+   */
+#if INA_COUNTERS
+  inaCounters counters;
+  INA.getCounters(counters);
+  if (calls == 0) return;
+  Serial.print(F("  I2C "));
+  Serial.print((float)counters.i2cTransactions / calls, 1);
+  Serial.print(F(" transactions "));
+  Serial.print((float)counters.i2cBytes / calls, 1);
+  Serial.print(F(" bytes "));
+  Serial.print((float)counters.delayMicros / calls, 1);
+  Serial.print(F("us delay, EEPROM "));
+  Serial.print((float)counters.eepromReads / calls, 2);
+  Serial.print(F(" reads "));
+  Serial.print((float)counters.cacheHits / calls, 2);
+  Serial.print(F(" cache hits"));
+#else
+  (void)calls;  // Counters are compiled out
+#endif
+}  // of method printCounters()
+
+uint32_t timeCalls(const uint8_t test) {
+  /*!
+   * @brief    Time BENCHMARK_CALLS calls of one library function on the first device
+   * @param[in] test Test from the "benchmarkTest" enumerated list
+   * @return   Microseconds taken by all calls
+   */
+  static inaReading readings[MAX_READINGS];  // Snapshot buffer for readAll()
+  INA.resetCounters();
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < BENCHMARK_CALLS; i++) {
+    switch (test) {
+      case TEST_BUS_MILLIVOLTS: sink += INA.getBusMilliVolts(0); break;
+      case TEST_SHUNT_MICROVOLTS: sink += INA.getShuntMicroVolts(0); break;
+      case TEST_BUS_MICROAMPS: sink += INA.getBusMicroAmps(0); break;
+      case TEST_BUS_MICROWATTS: sink += INA.getBusMicroWatts(0); break;
+      case TEST_BUS_RAW: sink += INA.getBusRaw(0); break;
+      case TEST_READ_ALL: sink += INA.readAll(readings, MAX_READINGS); break;
+    }  // of switch test
+  }    // of for-next each call
+  return (micros() - start);
+}  // of method timeCalls()
+
+uint32_t timeAcquisition(const uint8_t mode, const bool async) {
+  /*!
+   * @brief    Run the acquisition engine for BENCHMARK_MILLIS in the given mode
+   * @param[in] mode Operating mode, triggered or continuous, from the "ina_Mode" list
+   * @param[in] async Do one I2C transfer per "poll()" call, see "setAsync()"
+   * @return   Number of samples read
+   */
+  INA.setMode(mode);
+  INA.setAsync(async);
+  INA.resetCounters();
+  INA.startAcquisition();
+  uint32_t samples = 0;
+  uint32_t start   = millis();
+  while (millis() - start < BENCHMARK_MILLIS) samples += INA.poll();
+  INA.stopAcquisition();
+  INA.setAsync(false);
+  return (samples);
+}  // of method timeAcquisition()
+
+void setup() {
+  /*!
+   * @brief    Arduino method called once at startup to initialize the system
+   * @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+   *           called one time and then control goes to the "loop()" method, from which control
+   *           never returns. The serial port is initialized, the devices are found and set to
+   *           their fastest conversions
+   * @return   void
+   */
+  Serial.begin(SERIAL_SPEED);
+#ifdef __AVR_ATmega32U4__  // If a 32U4 processor, then wait 2 seconds to initialize serial port
+  delay(2000);
+#endif
+  Serial.print(F("\n\nINA Library Benchmark V1.0.1\n"));
+  devicesFound = INA.begin(MAXIMUM_AMPS, SHUNT_MICRO_OHM);  // Expected max Amp & shunt resistance
+  while (devicesFound == 0) {
+    Serial.println(F("No INA device found, retrying in 10 seconds..."));
+    delay(10000);                                             // Wait 10 seconds before retrying
+    devicesFound = INA.begin(MAXIMUM_AMPS, SHUNT_MICRO_OHM);  // Expected max Amp & shunt resistance
+  }                                                           // while no devices detected
+  Serial.print(F(" - Detected "));
+  Serial.print(devicesFound);
+  Serial.print(F(" INA devices, timing device 0, an "));
+  Serial.println(INA.getDeviceName(0));
+#if !INA_COUNTERS
+  Serial.println(F(" - Set INA_COUNTERS to 1 in INA.h to see the I2C and EEPROM traffic"));
+#endif
+  INA.setBusConversion(0);    // Shortest conversion time
+  INA.setShuntConversion(0);  // Shortest conversion time
+  INA.setAveraging(1);        // No averaging
+}  // method setup()
+
+void loop() {
+  /*!
+   * @brief    Arduino method for the main program loop
+   * @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+   *           repeating. The complete set of measurements is run at each I2C speed and repeated
+   *           every 30 seconds
+   * @return   void
+   */
+  for (uint8_t s = 0; s < sizeof(I2C_SPEEDS) / sizeof(I2C_SPEEDS[0]); s++) {
+    INA.setI2CSpeed(I2C_SPEEDS[s]);
+    Serial.print(F("\nI2C speed "));
+    Serial.print(I2C_SPEEDS[s] / 1000);
+    Serial.print(F("kHz\n"));
+    for (uint8_t test = 0; test < TEST_COUNT; test++) {
+      uint32_t elapsed = timeCalls(test);
+      printTestName(test);
+      printRate(elapsed, BENCHMARK_CALLS);
+      printCounters(BENCHMARK_CALLS);
+      Serial.println();
+    }  // of for-next each test
+    for (uint8_t continuous = 0; continuous < 2; continuous++) {
+      uint32_t samples = timeAcquisition(continuous ? INA_MODE_CONTINUOUS_BOTH
+                                                    : INA_MODE_TRIGGERED_BOTH,
+                                         false);
+      Serial.print(continuous ? F("poll() continuous    ") : F("poll() triggered     "));
+      printRate((uint32_t)BENCHMARK_MILLIS * 1000, samples);
+      printCounters(samples);
+      Serial.println();
+    }  // of for-next triggered and continuous
+    uint32_t samples = timeAcquisition(INA_MODE_CONTINUOUS_BOTH, true);
+    Serial.print(F("poll() asynchronous  "));
+    printRate((uint32_t)BENCHMARK_MILLIS * 1000, samples);
+    printCounters(samples);
+    Serial.println();
+  }    // of for-next each I2C speed
+  INA.setI2CSpeed(INA_I2C_STANDARD_MODE);  // Back to the default speed
+  delay(30000);                            // Wait 30 seconds before repeating
+}  // method loop()
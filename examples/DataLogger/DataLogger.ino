@@ -5,11 +5,12 @@
 
  The INA226 is set up to pull the alert pin down when a measurement is ready. The program has set
  the bus and shunt to the maximum conversion time of 8.244ms and then averaging to 8, so each
- measurement will take about 64ms. The interrupt vector "PCINT0_vect" is called and the readings
- from the INA226 are read and added to the averages.
+ measurement will take about 64ms. The interrupt vector "PCINT0_vect" is called and signals the
+ library's acquisition engine, which then reads the INA226 in the main loop and queues the raw
+ readings in a ring buffer. The main loop drains that buffer and adds the readings to the averages.
 
  A timer interrupt is defined in the setup() method that triggers a call to the vector
- "TIMER1_COMPA_vect" once every second.  The average values collected in the "PCINT0_vect" call are
+ "TIMER1_COMPA_vect" once every second.  The average values collected from the ring buffer are
  then taken and stored in memory. As the amount of RAM is limited and the absolute readings are 2
  Bytes long while the delta values to the previous measurement are usually quite small, a variable
  length Huffmann coding has been implemented at a nibble (4 bit) level to provide a higher-density
@@ -79,6 +80,7 @@
 
  Vers.  Date       Developer  Comments
  ====== ========== ========== ==============================================================
+ 1.0.4  2026-10-14 agent      Read device through the acquisition engine and sample ring buffer
  1.0.1  2020-06-30 SV-Zanshin Issue #58 - clang-formatted document
  1.0.0  2018-10-13 SV-Zanshin Ready for publishing
  1.0.0  2018-10-03 SV-Zanshin Cloned and adapted example
@@ -103,6 +105,7 @@ volatile uint8_t  readings       = 0;          // Number of measurements taken
 uint8_t           chips_detected = 0;          // Number of I2C FRAM chips detected
 volatile uint32_t framIndex      = 0;          // Index to the next free position
 INA_Class         INA;                         // INA class instantiation
+INA_RingBuffer<8> sampleRing;                  // Samples queued by the acquisition engine
 MB85_FRAM_Class   FRAM;                        // FRAM Memory class instantiation
 
 void writeNibble(uint8_t dataArray[], const uint16_t nibblePos, const uint8_t nibbleData) {
@@ -134,24 +137,10 @@ uint8_t readNibble(uint8_t dataArray[], const uint16_t nibblePos) {
 ISR(PCINT0_vect) {
   /************************************************************************************************
   ** Declare interrupt service routine for the pin-change interrupt on pin 8 which is set in the **
-  ** setup() method                                                                              **
+  ** setup() method. No I2C calls are made here, the library's acquisition engine is told that   **
+  ** the ALERT line went low and the device is read by "INA.poll()" in the main loop             **
   ************************************************************************************************/
-  static uint16_t tempsumBusRaw;    // Declare as static to only init 1
-  static int16_t  tempsumShuntRaw;  // Declare as static to only init 1
-  *digitalPinToPCMSK(INA_ALERT_PIN) &= ~bit(digitalPinToPCMSKbit(INA_ALERT_PIN));  // Disable PCMSK
-  PCICR &= ~bit(digitalPinToPCICRbit(INA_ALERT_PIN));        // disable interrupt for the group
-  digitalWrite(GREEN_LED_PIN, !digitalRead(GREEN_LED_PIN));  // Toggle LED to show we are working
-  sei();                                                     // Enable interrupts for I2C calls
-  tempsumBusRaw   = INA.getBusRaw(deviceNumber);             // Read the current value into temp
-  tempsumShuntRaw = INA.getShuntRaw(deviceNumber);           // Read the current value into temp
-  INA.waitForConversion(deviceNumber);                       // Resets interrupt flag and start
-  cli();                                                     // Disable interrupts
-  sumBusRaw += tempsumBusRaw;                                // copy value while ints disabled
-  sumShuntRaw += tempsumShuntRaw;                            // copy value while ints disabled
-  readings++;                                                // Increment the number of readings
-  *digitalPinToPCMSK(INA_ALERT_PIN) |= bit(digitalPinToPCMSKbit(INA_ALERT_PIN));  // Enable PCMSK
-  PCIFR |= bit(digitalPinToPCICRbit(INA_ALERT_PIN));  // clear any outstanding interrupt
-  PCICR |= bit(digitalPinToPCICRbit(INA_ALERT_PIN));  // enable interrupt for the group
+  if (!digitalRead(INA_ALERT_PIN)) INA.alertInterrupt();  // Only the falling edge is of interest
 }  // of ISR handler for INT0 group of pins
 void writeDataToArray(uint8_t dataArray[], uint16_t &nibbleIndex, const int16_t deltaData) {
   /************************************************************************************************
@@ -364,7 +353,7 @@ void setup()                             //                                  //
   delay(2000);                                        // wait 3 seconds for serial port   //
 #endif                                                // interface to initialize          //
   Serial.print(
-      F("\n\nINA Data Logging with interrupts V1.0.3\n"));  // Display program information      //
+      F("\n\nINA Data Logging with interrupts V1.0.4\n"));  // Display program information      //
   uint8_t devicesFound = 0;                                 // Number of INA2xx found on I2C    //
   while (deviceNumber == UINT8_MAX)                         // Loop until we find devices       //
   {                                                         //                                  //
@@ -393,7 +382,7 @@ void setup()                             //                                  //
   INA.setBusConversion(82440, deviceNumber);            // Maximum conversion time 8.244ms  //
   INA.setShuntConversion(82440, deviceNumber);          // Maximum conversion time 8.244ms  //
   INA.setMode(INA_MODE_CONTINUOUS_BOTH, deviceNumber);  // Bus/shunt measured continuously  //
-  INA.AlertOnConversion(true, deviceNumber);            // Make alert pin go low on finish  //
+  INA.startAcquisition(sampleRing, true);               // Queue samples using ALERT pin    //
   chips_detected = FRAM.begin();                        // return number of memories        //
   if (chips_detected > 0) {                             //                                  //
     Serial.print(F("Found "));                          //                                  //
@@ -418,13 +407,21 @@ void setup()                             //                                  //
 }  // of method setup()                                                        // //
 
 /*******************************************************************************************************************
-** This is the main program for the Arduino IDE, it is called in an infinite loop. The INA226
-*measurements are    **
-** triggered by the interrupt handler each time a conversion is ready, and another interrupt is
-*triggered every   **
-** second to store the collected readings. Thus the main program is free to do other tasks. **
+** This is the main program for the Arduino IDE, it is called in an infinite loop. The INA226   **
+** measurements are read by "INA.poll()" each time the interrupt handler has signalled that a   **
+** conversion is ready and are queued in "sampleRing", which is drained here in batches. The    **
+** TIMER1 interrupt is triggered every second to store the collected readings.                  **
 *******************************************************************************************************************/
-void loop()  //                                  //
-{            //                                  //
-  delay(10000);
-}  // of method loop //----------------------------------//
+void loop() {
+  inaRawSample batch[4];  // Samples taken from the ring in one go
+  INA.poll();             // Read the INA226 if the ALERT line went low
+  uint8_t count = sampleRing.popBatch(batch, 4);
+  for (uint8_t i = 0; i < count; i++) {
+    digitalWrite(GREEN_LED_PIN, !digitalRead(GREEN_LED_PIN));  // Toggle LED to show we are working
+    cli();                                          // Sums are shared with the TIMER1 interrupt
+    sumBusRaw += batch[i].busRaw;                   // Add the raw values to the sums
+    sumShuntRaw += (int16_t)batch[i].shuntRaw;      // The shunt register is signed
+    readings++;                                     // Increment the number of readings
+    sei();                                          // Re-enable interrupts
+  }  // of for-next each sample taken from the ring
+}  // of method loop
@@ -0,0 +1,508 @@
+/*!
+ @file Simulation.ino
+
+ @brief Example program for the INA Library running on simulated devices
+
+ @section Simulation_section Description
+
+ Program to demonstrate the "INA_Simulator" from "INA_Simulator.h", which stands in for the I2C
+ bus and answers with the registers of an INA219, INA226, INA228, INA260 and INA3221 so that no INA
+ device needs to be attached. The bus and shunt voltages of the simulated devices are stepped
+ through a set of values, every reading is checked against the value it should convert to and the
+ result is shown as a regression check. Triggered conversions, the acquisition engine in both of
+ its modes, failing bus transfers, the INA228 shunt ranges and duty cycling are checked as well.
+ Then the getters, "readAll()" and the acquisition engine are timed. As the simulated bus takes no
+ time to transfer the data, the times show what the library itself costs on the processor it runs
+ on.\n\n
+
+ The same program can be compiled on a host computer together with the emulation of the Arduino
+ core in "extras/host", which allows checking and benchmarking the library in an automated build,
+ see "extras/host/CMakeLists.txt". There the program makes a single pass and its exit status is
+ the result of the check, non-zero if any check failed.\n\n
+
+ Detailed documentation can be found on the GitHub Wiki pages at
+ https://github.com/Zanduino/INA/wiki
+
+ @section Simulation_license GNU General Public License v3.0
+
+ This program is free software : you can redistribute it and/or modify it under the terms of the
+ GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ License, or (at your option) any later version.This program is distributed in the hope that it
+ will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.You should
+ have received a copy of the GNU General Public License along with this program(see
+ https://github.com/Zanduino/INA/blob/master/LICENSE).  If not, see
+ <http://www.gnu.org/licenses/>.
+
+ @section Simulation_author Author
+
+ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+ @section Simulation_versions Changelog
+
+ | Version | Date       | Developer  | Comments                                                    |
+ | ------- | ---------- | -----------| ----------------------------------------------------------- |
+ | 1.0.1   | 2026-10-15 | agent      | Check shunt, power, triggered mode, poll(), bus errors, ADC |
+ | 1.0.0   | 2026-10-14 | agent      | Initial coding                                              |
+*/
+
+#if ARDUINO >= 100  // Arduino IDE versions before 100 need to use the older library
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include <INA.h>            // Zanshin INA Library
+#include <INA_Simulator.h>  // Simulated INA devices
+
+/**************************************************************************************************
+** Declare program constants, global variables and instantiate INA class                         **
+**************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};     ///< Use fast serial speed
+const uint32_t SHUNT_MICRO_OHM{100000};  ///< Shunt resistance in Micro-Ohm, e.g. 100000 is 0.1 Ohm
+const uint32_t FINE_MICRO_OHM{20000};    ///< Shunt small enough for the finer INA228 range
+const uint16_t MAXIMUM_AMPS{1};          ///< Max expected amps, clamped from 1A to a max of 1022A
+const uint8_t  MAX_READINGS{8};          ///< Simulated channels, the INA3221 counts 3 times
+const uint16_t BENCHMARK_CALLS{500};     ///< Number of calls timed per library call
+const uint32_t POLL_TIMEOUT{2000000};    ///< Microseconds to wait for the acquisition engine
+const uint8_t  INA228_ADDRESS{0x44};     ///< Address of the simulated INA228
+const uint8_t  SIMULATED_ADDRESSES[]{0x40, 0x41, INA228_ADDRESS, 0x45, 0x46};  ///< One device each
+const uint8_t  SIMULATED_TYPES[]{INA219, INA226, INA228, INA260, INA3221_0};  ///< Device types
+const uint32_t BUS_MICROVOLTS[]{3300000, 5000000, 12000000, 24000000};        ///< Steps to check
+const int32_t  SHUNT_NANOVOLTS[]{-20000000, -1000000, 2500000, 30000000};     ///< Steps to check
+INA_Simulator<5> simulator;          ///< Simulated I2C bus with 5 devices
+INA_Class        INA(MAX_READINGS);  ///< INA class instantiation, device records in RAM
+uint8_t          devicesFound{0};    ///< Number of INAs found
+uint8_t          channels{0};        ///< Number of simulated channels, the library should find all
+uint8_t          ina228{UINT8_MAX};  ///< Device number of the simulated INA228
+uint16_t         checks{0};          ///< Number of checks made in this pass
+uint16_t         failures{0};        ///< Number of checks which failed in this pass
+volatile int64_t sink{0};  ///< Results are added here so the calls can't be optimized away
+
+int32_t magnitude(const int64_t value) {
+  /*!
+   * @brief    Return the absolute value of a reading
+   * @param[in] value Reading
+   * @return   Absolute value
+   */
+  return (value < 0 ? -value : value);
+}  // of method magnitude()
+
+bool check(const bool passed, const uint8_t deviceNumber) {
+  /*!
+   * @brief    Count a check and report it if it failed
+   * @param[in] passed Result of the check
+   * @param[in] deviceNumber Device the check was made on, UINT8_MAX if none
+   * @return   "passed"
+   */
+  checks++;
+  if (!passed) {
+    failures++;
+    Serial.print(F("FAIL check "));
+    Serial.print(checks);
+    if (deviceNumber != UINT8_MAX) {
+      Serial.print(F(" device "));
+      Serial.print(deviceNumber);
+      Serial.print(F(" "));
+      Serial.print(INA.getDeviceName(deviceNumber));
+    }  // of if-then a device
+    Serial.println();
+  }  // of if-then failed
+  return (passed);
+}  // of method check()
+
+bool sameReading(const inaReading &first, const inaReading &second) {
+  /*!
+   * @brief    Compare the converted values of two readings, the timestamps may differ
+   * @param[in] first First reading
+   * @param[in] second Second reading
+   * @return   "true" if the readings are identical
+   */
+  return (first.busMilliVolts == second.busMilliVolts &&
+          first.shuntMicroVolts == second.shuntMicroVolts &&
+          first.busMicroAmps == second.busMicroAmps && first.busMicroWatts == second.busMicroWatts);
+}  // of method sameReading()
+
+bool checkValues(const uint8_t deviceNumber, const inaReading &reading,
+                 const uint32_t busMicroVolts, const int32_t shuntNanoVolts,
+                 const uint32_t microOhmR = SHUNT_MICRO_OHM) {
+  /*!
+   * @brief    Check a reading of a device against the voltages its simulation was set to
+   * @details  Each value may be off by the resolution of the device: 1 LSB of the bus and shunt
+   *           ADC plus rounding, and for the current the shunt step, the current LSB and the
+   *           rounding of the calibration register, which is at least 1024 and so off by 1/1024 of
+   *           the current at most. The power may be off by those errors multiplied out plus 2 power
+   *           LSB and has to have the sign of the current. The INA260 has no shunt register and
+   *           measures over its internal 2 milli-Ohm shunt
+   * @param[in] deviceNumber Device the values were read from
+   * @param[in] reading Values read
+   * @param[in] busMicroVolts Bus voltage the simulated device measures
+   * @param[in] shuntNanoVolts Shunt voltage the simulated device measures
+   * @param[in] microOhmR [optional] Shunt resistance given to "begin()"
+   * @return   "true" if the readings match
+   */
+  inaDeviceInfo info;
+  if (!INA.getDeviceInfo(deviceNumber, info)) return (false);
+  int32_t busTolerance, shuntTolerance, ampsTolerance;  // mV, uV and uA
+  switch (info.type) {
+    case INA219:
+      busTolerance   = 5;
+      shuntTolerance = 11;
+      break;
+    case INA228:
+      busTolerance   = 1;
+      shuntTolerance = 1;
+      break;
+    case INA3221_0:
+    case INA3221_1:
+    case INA3221_2:
+      busTolerance   = 9;
+      shuntTolerance = 41;
+      break;
+    default:  // INA226 and INA260
+      busTolerance   = 2;
+      shuntTolerance = 3;
+  }  // of switch type
+  int32_t expectedAmps = shuntNanoVolts / (int32_t)(microOhmR / 1000);  // I = V / R
+  if (info.type == INA260) {
+    expectedAmps  = shuntNanoVolts / 2;  // Internal 2 milli-Ohm shunt
+    ampsTolerance = 1251;                // Fixed 1.25mA LSB
+  } else {
+    ampsTolerance = (int64_t)shuntTolerance * 1000000 / microOhmR + info.current_LSB / 1000 +
+                    magnitude(expectedAmps) / 1024 + 1;
+  }  // of if-then-else an INA260
+  int64_t expectedWatts = (int64_t)busMicroVolts * expectedAmps / 1000000;
+  int64_t wattsTolerance = ((int64_t)busTolerance * 1000 * magnitude(expectedAmps) +
+                            (int64_t)busMicroVolts * ampsTolerance) / 1000000 +
+                           2 * (int64_t)info.power_LSB / 1000 + 1;
+  bool passed = magnitude((int32_t)reading.busMilliVolts - (int32_t)(busMicroVolts / 1000)) <=
+                    busTolerance &&
+                magnitude(reading.busMicroAmps - expectedAmps) <= ampsTolerance &&
+                magnitude(reading.busMicroWatts - expectedWatts) <= wattsTolerance &&
+                (reading.busMicroWatts == 0 || (reading.busMicroWatts < 0) == (expectedAmps < 0));
+  if (info.type != INA260) {
+    passed = passed && magnitude(reading.shuntMicroVolts - shuntNanoVolts / 1000) <= shuntTolerance;
+  }  // of if-then device has a shunt register
+  return (passed);
+}  // of method checkValues()
+
+void setReadings(const uint32_t busMicroVolts, const int32_t shuntNanoVolts) {
+  /*!
+   * @brief    Set the voltages of every channel of every simulated device
+   * @param[in] busMicroVolts Bus voltage in microvolts
+   * @param[in] shuntNanoVolts Shunt voltage in nanovolts
+   */
+  for (uint8_t i = 0; i < sizeof(SIMULATED_ADDRESSES); i++) {
+    for (uint8_t ch = 0; ch < (SIMULATED_TYPES[i] == INA3221_0 ? 3 : 1); ch++) {
+      simulator.setReading(SIMULATED_ADDRESSES[i], busMicroVolts, shuntNanoVolts, ch);
+    }  // of for-next each channel
+  }    // of for-next each simulated device
+}  // of method setReadings()
+
+void checkConversions() {
+  /*!
+   * @brief    Step through the bus and shunt voltages and check the getters and "readAll()"
+   */
+  static inaReading snapshot[MAX_READINGS];  // Readings of all devices from readAll()
+  for (uint8_t b = 0; b < sizeof(BUS_MICROVOLTS) / sizeof(BUS_MICROVOLTS[0]); b++) {
+    for (uint8_t s = 0; s < sizeof(SHUNT_NANOVOLTS) / sizeof(SHUNT_NANOVOLTS[0]); s++) {
+      setReadings(BUS_MICROVOLTS[b], SHUNT_NANOVOLTS[s]);
+      INA.readAll(snapshot, MAX_READINGS);
+      for (uint8_t i = 0; i < devicesFound; i++) {
+        inaReading reading;
+        reading.busMilliVolts   = INA.getBusMilliVolts(i);
+        reading.shuntMicroVolts = INA.getShuntMicroVolts(i);
+        reading.busMicroAmps    = INA.getBusMicroAmps(i);
+        reading.busMicroWatts   = INA.getBusMicroWatts(i);
+        check(checkValues(i, reading, BUS_MICROVOLTS[b], SHUNT_NANOVOLTS[s]) &&
+                  checkValues(i, snapshot[i], BUS_MICROVOLTS[b], SHUNT_NANOVOLTS[s]) &&
+                  !INA.readFailed(),
+              i);
+      }  // of for-next each device
+    }    // of for-next each shunt voltage
+  }      // of for-next each bus voltage
+}  // of method checkConversions()
+
+void checkTriggered() {
+  /*!
+   * @brief    Check that triggered devices only convert when started
+   * @details  "triggerAll()" starts a conversion of the voltages set at that time, a change made
+   *           afterwards is not seen by "collectAll()". "readAll()" returns the last conversion and
+   *           starts the next one
+   */
+  static inaReading snapshot[MAX_READINGS];  // Readings of all devices
+  INA.setMode(INA_MODE_TRIGGERED_BOTH);
+  setReadings(5000000, 2500000);
+  INA.triggerAll();
+  setReadings(12000000, -1000000);  // Not converted until the next trigger
+  check(INA.collectAll(snapshot, MAX_READINGS) == devicesFound, UINT8_MAX);
+  for (uint8_t i = 0; i < devicesFound; i++) {
+    check(checkValues(i, snapshot[i], 5000000, 2500000), i);
+  }  // of for-next each device
+  INA.triggerAll();
+  INA.readAll(snapshot, MAX_READINGS);  // Reads the last conversion and triggers the next
+  for (uint8_t i = 0; i < devicesFound; i++) {
+    check(checkValues(i, snapshot[i], 12000000, -1000000), i);
+  }                                // of for-next each device
+  setReadings(3300000, 30000000);  // Converted by the trigger of the next readAll()
+  INA.readAll(snapshot, MAX_READINGS);
+  for (uint8_t i = 0; i < devicesFound; i++) {
+    check(checkValues(i, snapshot[i], 12000000, -1000000), i);
+  }  // of for-next each device
+  INA.readAll(snapshot, MAX_READINGS);
+  for (uint8_t i = 0; i < devicesFound; i++) {
+    check(checkValues(i, snapshot[i], 3300000, 30000000), i);
+  }  // of for-next each device
+  INA.setMode(INA_MODE_CONTINUOUS_BOTH);
+  check(!INA.readFailed(), UINT8_MAX);
+}  // of method checkTriggered()
+
+void checkAcquisition(const bool async) {
+  /*!
+   * @brief    Check that "poll()" and "getSample()" return the same values as "readAll()"
+   * @param[in] async Run the engine with one I2C transfer per "poll()", see "setAsync()"
+   */
+  static inaReading snapshot[MAX_READINGS];  // Readings of all devices from readAll()
+  setReadings(12000000, 2500000);
+  INA.readAll(snapshot, MAX_READINGS);
+  INA.setAsync(async);
+  INA.startAcquisition();
+  bool     sampled[MAX_READINGS]{};
+  uint8_t  count = 0;
+  uint32_t start = micros();
+  while (count < devicesFound && micros() - start < POLL_TIMEOUT) {
+    INA.poll();
+    for (uint8_t i = 0; i < devicesFound; i++) {
+      inaReading reading;
+      if (sampled[i] || !INA.getSample(i, reading)) continue;
+      sampled[i] = true;
+      count++;
+      check(sameReading(reading, snapshot[i]), i);
+    }  // of for-next each device
+  }    // of while-loop samples missing
+  check(count == devicesFound, UINT8_MAX);
+  INA.stopAcquisition();
+  INA.setAsync(false);
+  check(!INA.readFailed(), UINT8_MAX);
+}  // of method checkAcquisition()
+
+void checkBusErrors() {
+  /*!
+   * @brief    Check that failed transfers are reported and the samples they would corrupt dropped
+   * @details  A failed "readAll()" is flagged by "readFailed()" unless a retry recovered it. The
+   *           engine uses the timing model here, so that the failed transfer is a register read
+   *           and not the check of the conversion-ready flag
+   */
+  static inaReading snapshot[MAX_READINGS];  // Readings of all devices from readAll()
+  setReadings(5000000, -1000000);
+  simulator.failTransfers(1);
+  INA.readAll(snapshot, MAX_READINGS);
+  check(INA.readFailed(), UINT8_MAX);
+  INA.setI2CRetries(1);
+  simulator.failTransfers(1);
+  INA.readAll(snapshot, MAX_READINGS);
+  check(!INA.readFailed(), UINT8_MAX);
+  for (uint8_t i = 0; i < devicesFound; i++) {
+    check(checkValues(i, snapshot[i], 5000000, -1000000), i);
+  }  // of for-next each device
+  INA.setI2CRetries(0);
+  INA.setStatistics(true);
+  INA.setTimedReads(true);
+  INA.startAcquisition();
+  uint32_t dropped = 0;
+  uint32_t start   = micros();
+  while (dropped == 0 && micros() - start < POLL_TIMEOUT) {
+    simulator.failTransfers(1);
+    INA.poll();
+    for (uint8_t i = 0; i < devicesFound; i++) {
+      inaReading reading;
+      if (INA.getSample(i, reading)) check(checkValues(i, reading, 5000000, -1000000), i);
+    }  // of for-next each device
+    dropped = 0;
+    for (uint8_t i = 0; i < devicesFound; i++) {
+      inaStatistics statistics;
+      if (INA.getStatistics(i, statistics)) dropped += statistics.dropped;
+    }  // of for-next each device
+  }    // of while-loop nothing dropped
+  simulator.failTransfers(0);
+  check(dropped != 0, UINT8_MAX);
+  check(INA.readFailed(), UINT8_MAX);
+  INA.stopAcquisition();
+  INA.setTimedReads(false);
+  INA.setStatistics(false);
+}  // of method checkBusErrors()
+
+bool fineRange() {
+  /*!
+   * @brief    Return whether the simulated INA228 uses its finer shunt range
+   * @return   "true" if the ADCRANGE bit is set
+   */
+  return (bitRead(simulator.getRegister(INA228_ADDRESS, INA_CONFIGURATION_REGISTER),
+                  INA228_ADCRANGE_BIT));
+}  // of method fineRange()
+
+bool autoRangeTo(const int32_t shuntNanoVolts, const bool fine) {
+  /*!
+   * @brief    Poll the INA228 at a shunt voltage until it has switched to a range
+   * @details  Samples taken before the switch are not checked, the one which switches to the wider
+   *           range is clipped by the finer one. The first sample taken in the new range has to be
+   *           correct
+   * @param[in] shuntNanoVolts Shunt voltage the simulated device measures
+   * @param[in] fine Range expected, "true" for the finer one
+   * @return   "true" if the range was reached and the next sample was correct
+   */
+  inaReading reading;
+  uint32_t   start = micros();
+  setReadings(12000000, shuntNanoVolts);
+  while (fineRange() != fine && micros() - start < POLL_TIMEOUT) INA.poll();
+  INA.getSample(ina228, reading);  // Discard a sample from before the switch
+  while (!INA.getSample(ina228, reading) && micros() - start < POLL_TIMEOUT) INA.poll();
+  return (fineRange() == fine && micros() - start < POLL_TIMEOUT &&
+          checkValues(ina228, reading, 12000000, shuntNanoVolts));
+}  // of method autoRangeTo()
+
+void checkAdcRange() {
+  /*!
+   * @brief    Check the shunt ranges of the INA228
+   * @details  "begin()" chooses the finer range when the largest shunt voltage fits into it, and
+   *           auto-ranging switches to it for small currents and back for large ones. A 30mV shunt
+   *           limit has to stay at 30mV in both ranges, which have a 5uV and a 1.25uV limit LSB
+   */
+  if (!check(ina228 != UINT8_MAX, UINT8_MAX)) return;
+  check(!fineRange(), ina228);  // 1A over 0.1 Ohm needs the wider range
+  INA.begin(MAXIMUM_AMPS, FINE_MICRO_OHM, ina228);
+  check(fineRange(), ina228);
+  setReadings(12000000, 2500000);
+  inaReading reading;
+  reading.busMilliVolts   = INA.getBusMilliVolts(ina228);
+  reading.shuntMicroVolts = INA.getShuntMicroVolts(ina228);
+  reading.busMicroAmps    = INA.getBusMicroAmps(ina228);
+  reading.busMicroWatts   = INA.getBusMicroWatts(ina228);
+  check(checkValues(ina228, reading, 12000000, 2500000, FINE_MICRO_OHM), ina228);
+  INA.begin(MAXIMUM_AMPS, SHUNT_MICRO_OHM, ina228);
+  check(!fineRange(), ina228);
+  INA.alertOnShuntOverVoltage(true, 30, ina228);
+  check(INA.setAutoRange(true, ina228), ina228);
+  INA.startAcquisition();
+  check(autoRangeTo(1000000, true), ina228);  // Fits into half of the finer range
+  check(simulator.getRegister(INA228_ADDRESS, INA228_SHUNT_OVER_REGISTER) == 24000 &&
+            simulator.getRegister(INA228_ADDRESS, INA228_SHUNT_UNDER_REGISTER) == 0x8000,
+        ina228);
+  check(autoRangeTo(60000000, false), ina228);  // Beyond the finer range
+  check(simulator.getRegister(INA228_ADDRESS, INA228_SHUNT_OVER_REGISTER) == 6000, ina228);
+  INA.stopAcquisition();
+  INA.setAutoRange(false, ina228);
+  INA.alertOnShuntOverVoltage(false, 0, ina228);
+  check(!fineRange() && !INA.readFailed() &&
+            simulator.getRegister(INA228_ADDRESS, INA228_SHUNT_OVER_REGISTER) == 0x7FFF,
+        ina228);
+}  // of method checkAdcRange()
+
+void checkDutyCycle() {
+  /*!
+   * @brief    Check that duty cycling shuts the devices down between samples, except the INA228
+   * @details  The INA228 keeps converting so that its energy and charge registers keep counting,
+   *           see "setSamplePeriod()"
+   */
+  const uint8_t  ina226Address = SIMULATED_ADDRESSES[1];
+  const uint64_t ina228Mode    = simulator.getRegister(INA228_ADDRESS, INA228_ADC_CONFIG_REGISTER);
+  INA.setSamplePeriod(POLL_TIMEOUT);  // Long enough for the devices to stay asleep
+  INA.startAcquisition();
+  uint32_t start = micros();
+  while ((simulator.getRegister(ina226Address, INA_CONFIGURATION_REGISTER) & 3) != 0 &&
+         micros() - start < POLL_TIMEOUT) {
+    INA.poll();
+  }  // of while-loop INA226 not shut down yet
+  check((simulator.getRegister(ina226Address, INA_CONFIGURATION_REGISTER) & 3) == 0, 1);
+  check(simulator.getRegister(INA228_ADDRESS, INA228_ADC_CONFIG_REGISTER) == ina228Mode, ina228);
+  INA.stopAcquisition();
+  INA.setSamplePeriod(0);
+  check((simulator.getRegister(ina226Address, INA_CONFIGURATION_REGISTER) & 7) == 7, 1);
+}  // of method checkDutyCycle()
+
+uint32_t timeCalls(const uint8_t test) {
+  /*!
+   * @brief    Time BENCHMARK_CALLS calls of a library function across all devices
+   * @param[in] test 0 getBusMilliVolts(), 1 getBusMicroAmps(), 2 readAll(), 3 poll()
+   * @return   Microseconds taken by all calls
+   */
+  static inaReading readings[MAX_READINGS];  // Snapshot buffer for readAll()
+  uint32_t          start = micros();
+  for (uint16_t i = 0; i < BENCHMARK_CALLS; i++) {
+    uint8_t device = i % devicesFound;
+    switch (test) {
+      case 0: sink += INA.getBusMilliVolts(device); break;
+      case 1: sink += INA.getBusMicroAmps(device); break;
+      case 2: sink += INA.readAll(readings, MAX_READINGS); break;
+      case 3: sink += INA.poll(); break;
+    }  // of switch test
+  }    // of for-next each call
+  return (micros() - start);
+}  // of method timeCalls()
+
+void setup() {
+  /*!
+   * @brief    Arduino method called once at startup to initialize the system
+   * @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+   *           called one time and then control goes to the "loop()" method, from which control
+   *           never returns. The simulated devices are created and found by the library
+   * @return   void
+   */
+  Serial.begin(SERIAL_SPEED);
+#ifdef __AVR_ATmega32U4__  // If a 32U4 processor, then wait 2 seconds to initialize serial port
+  delay(2000);
+#endif
+  Serial.print(F("\n\nINA Library Simulation V1.0.1\n"));
+  for (uint8_t i = 0; i < sizeof(SIMULATED_TYPES); i++) {
+    simulator.addDevice(SIMULATED_ADDRESSES[i], SIMULATED_TYPES[i]);
+    channels += SIMULATED_TYPES[i] == INA3221_0 ? 3 : 1;
+  }                             // of for-next each simulated device
+  INA.setTransport(simulator);  // Use the simulated bus instead of "Wire"
+  devicesFound = INA.begin(MAXIMUM_AMPS, SHUNT_MICRO_OHM);  // Expected max Amp & shunt resistance
+  for (uint8_t i = 0; i < devicesFound; i++) {
+    if (INA.getDeviceAddress(i) == INA228_ADDRESS) ina228 = i;
+  }  // of for-next each device
+  Serial.print(F(" - Detected "));
+  Serial.print(devicesFound);
+  Serial.println(F(" simulated INA devices"));
+}  // method setup()
+
+void loop() {
+  /*!
+   * @brief    Arduino method for the main program loop
+   * @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+   *           repeating. The library is checked and its calls timed every 10 seconds. A host build
+   *           stops after the first pass, see the description above
+   * @return   void
+   */
+  checks   = 0;
+  failures = 0;
+  check(devicesFound == channels, UINT8_MAX);
+  checkConversions();
+  checkTriggered();
+  checkAcquisition(false);
+  checkAcquisition(true);
+  checkBusErrors();
+  checkAdcRange();
+  checkDutyCycle();
+  Serial.print(checks - failures);
+  Serial.print(F(" of "));
+  Serial.print(checks);
+  Serial.println(F(" checks passed"));
+  INA.startAcquisition();
+  for (uint8_t test = 0; test < 4; test++) {
+    uint32_t elapsed = timeCalls(test);
+    switch (test) {
+      case 0: Serial.print(F("getBusMilliVolts() ")); break;
+      case 1: Serial.print(F("getBusMicroAmps()  ")); break;
+      case 2: Serial.print(F("readAll()          ")); break;
+      case 3: Serial.print(F("poll()             ")); break;
+    }  // of switch test
+    Serial.print((float)elapsed / BENCHMARK_CALLS, 3);
+    Serial.println(F("us per call"));
+  }  // of for-next each test
+  INA.stopAcquisition();
+#ifdef INA_HOST_BUILD
+  exit(failures ? EXIT_FAILURE : EXIT_SUCCESS);  // Result of the checks
+#endif
+  delay(10000);  // Wait 10 seconds before repeating
+}  // method loop()
@@ -0,0 +1,93 @@
+/*!
+ @file StaticDevice.ino
+
+ @brief Example program for the INA Library demonstrating the compile-time configured driver
+
+ @section StaticDevice_section Description
+
+ Program to demonstrate the "INA_Device" template from "INA_Device.h". Instead of searching the
+ I2C bus at runtime, the device type, I2C address, maximum current and shunt resistance are given
+ as template parameters. All register addresses and calibration values are then computed by the
+ compiler and only the code for the INA226 used here ends up in the program, which makes it
+ noticeably smaller and faster than the same program using "INA_Class". The example program goes
+ into an infinite loop and displays the bus voltage, shunt voltage, current and power of the device
+ every 5 seconds.\n\n
+
+ This example is for an INA226 at address 0x40 set up to measure a 5-Volt load with a 0.1 Ohm
+ resistor in place, change the template parameters to match the hardware being used. Detailed
+ documentation can be found on the GitHub Wiki pages at https://github.com/Zanduino/INA/wiki
+
+ @section StaticDevice_license GNU General Public License v3.0
+
+ This program is free software : you can redistribute it and/or modify it under the terms of the
+ GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ License, or (at your option) any later version.This program is distributed in the hope that it
+ will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.You should
+ have received a copy of the GNU General Public License along with this program(see
+ https://github.com/Zanduino/INA/blob/master/LICENSE).  If not, see
+ <http://www.gnu.org/licenses/>.
+
+ @section StaticDevice_author Author
+
+ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+ @section StaticDevice_versions Changelog
+
+ | Version | Date       | Developer  | Comments                                                    |
+ | ------- | ---------- | -----------| ----------------------------------------------------------- |
+ | 1.0.0   | 2026-10-14 | agent      | Initial coding                                              |
+*/
+
+#if ARDUINO >= 100  // Arduino IDE versions before 100 need to use the older library
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include <INA_Device.h>  // Zanshin INA Library, compile-time configured devices
+
+/**************************************************************************************************
+** Declare program constants, global variables and instantiate the INA device                    **
+**************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};     ///< Use fast serial speed
+const uint32_t SHUNT_MICRO_OHM{100000};  ///< Shunt resistance in Micro-Ohm, e.g. 100000 is 0.1 Ohm
+const uint16_t MAXIMUM_AMPS{1};          ///< Max expected amps
+INA_Device<INA226, 0x40, MAXIMUM_AMPS, SHUNT_MICRO_OHM> INA;  ///< INA226 at I2C address 0x40
+
+void setup() {
+  /*!
+   * @brief    Arduino method called once at startup to initialize the system
+   * @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+   *           called one time and then control goes to the "loop()" method, from which control
+   *           never returns. The serial port and I2C bus are initialized and the device is reset
+   *           and calibrated
+   * @return   void
+   */
+  Serial.begin(SERIAL_SPEED);
+#ifdef __AVR_ATmega32U4__  // If a 32U4 processor, then wait 2 seconds to initialize serial port
+  delay(2000);
+#endif
+  Serial.print(F("\n\nStatic INA Device V1.0.0\n"));
+  Wire.begin();                           // Start the I2C bus
+  INA.begin();                            // Reset and calibrate the device
+  INA.setMode(INA_MODE_CONTINUOUS_BOTH);  // Bus/shunt measured continuously
+}  // method setup()
+
+void loop() {
+  /*!
+   * @brief    Arduino method for the main program loop
+   * @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+   *           repeating. The readings are displayed every 5 seconds
+   * @return   void
+   */
+  Serial.print(F("Bus: "));
+  Serial.print(INA.getBusMilliVolts() / 1000.0, 4);
+  Serial.print(F("V Shunt: "));
+  Serial.print(INA.getShuntMicroVolts() / 1000.0, 4);
+  Serial.print(F("mV Current: "));
+  Serial.print(INA.getBusMicroAmps() / 1000.0, 4);
+  Serial.print(F("mA Power: "));
+  Serial.print(INA.getBusMicroWatts() / 1000.0, 4);
+  Serial.print(F("mW\n"));
+  delay(5000);  // Wait 5 seconds before next reading
+}  // method loop()
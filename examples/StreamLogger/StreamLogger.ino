@@ -0,0 +1,103 @@
+/*!
+ @file StreamLogger.ino
+
+ @brief Example program for the INA Library streaming raw samples in a compact binary format
+
+ @section StreamLogger_section Description
+
+ Program to log the readings of all INA devices found as a binary stream over the serial port. The
+ library's acquisition engine reads the devices as their conversions finish and queues the raw
+ samples in a ring buffer, the main loop drains the buffer into an "INA_StreamEncoder" which writes
+ each sample as differences to the previous one, usually 6 to 9 bytes per sample instead of the 40
+ or more bytes of a line of text. That allows 5 to 10 times more samples per second through a
+ 115200 Baud link, or as much smaller log files when the encoder writes to an SD card file instead
+ of "Serial".\n\n
+
+ The stream starts with a header holding the calibration of each device, so the host needs no
+ knowledge of the devices to convert the samples. The format is described with the
+ "INA_SampleEncoder" class in "INA.h". The output is binary and not meant to be read in the serial
+ monitor, capture it with a terminal program or script and decode it on the host.\n\n
+
+ Detailed documentation can be found on the GitHub Wiki pages at
+ https://github.com/Zanduino/INA/wiki
+
+ @section StreamLogger_license GNU General Public License v3.0
+
+ This program is free software : you can redistribute it and/or modify it under the terms of the
+ GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ License, or (at your option) any later version.This program is distributed in the hope that it
+ will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.You should
+ have received a copy of the GNU General Public License along with this program(see
+ https://github.com/Zanduino/INA/blob/master/LICENSE).  If not, see
+ <http://www.gnu.org/licenses/>.
+
+ @section StreamLogger_author Author
+
+ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+ @section StreamLogger_versions Changelog
+
+ | Version | Date       | Developer  | Comments                                                    |
+ | ------- | ---------- | -----------| ----------------------------------------------------------- |
+ | 1.0.0   | 2026-10-14 | agent      | Initial coding                                              |
+*/
+
+#if ARDUINO >= 100  // Arduino IDE versions before 100 need to use the older library
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include <INA.h>  // Zanshin INA Library
+
+/**************************************************************************************************
+** Declare program constants, global variables and instantiate INA class                         **
+**************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};     ///< Use fast serial speed
+const uint32_t SHUNT_MICRO_OHM{100000};  ///< Shunt resistance in Micro-Ohm, e.g. 100000 is 0.1 Ohm
+const uint16_t MAXIMUM_AMPS{1};          ///< Max expected amps, clamped from 1A to a max of 1022A
+const uint8_t  MAX_DEVICES{8};           ///< Devices logged, an INA3221 counts as 3 devices
+const uint8_t  BATCH_SIZE{8};            ///< Samples taken from the ring buffer at a time
+INA_Class                      INA;              ///< INA class instantiation to use EEPROM
+INA_RingBuffer<32>             sampleRing;       ///< Samples queued by the acquisition engine
+INA_StreamEncoder<MAX_DEVICES> encoder(Serial);  ///< Binary encoder writing to the serial port
+uint8_t                        devicesFound{0};  ///< Number of INAs found
+
+void setup() {
+  /*!
+   * @brief    Arduino method called once at startup to initialize the system
+   * @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+   *           called one time and then control goes to the "loop()" method, from which control
+   *           never returns. The devices are found, the stream header written and the acquisition
+   *           engine started
+   * @return   void
+   */
+  Serial.begin(SERIAL_SPEED);
+#ifdef __AVR_ATmega32U4__  // If a 32U4 processor, then wait 2 seconds to initialize serial port
+  delay(2000);
+#endif
+  devicesFound = INA.begin(MAXIMUM_AMPS, SHUNT_MICRO_OHM);  // Expected max Amp & shunt resistance
+  while (devicesFound == 0) {
+    delay(10000);                                             // Wait 10 seconds before retrying
+    devicesFound = INA.begin(MAXIMUM_AMPS, SHUNT_MICRO_OHM);  // Expected max Amp & shunt resistance
+  }                                                           // while no devices detected
+  INA.setBusConversion(1100);             // Maximum conversion time 1.1ms
+  INA.setShuntConversion(1100);           // Maximum conversion time 1.1ms
+  INA.setAveraging(4);                    // Average each reading 4 times
+  INA.setMode(INA_MODE_CONTINUOUS_BOTH);  // Bus/shunt measured continuously
+  encoder.writeHeader(INA);               // Describe the devices ahead of the samples
+  INA.startAcquisition(sampleRing);       // Queue the samples as the devices finish
+}  // method setup()
+
+void loop() {
+  /*!
+   * @brief    Arduino method for the main program loop
+   * @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+   *           repeating. The devices are polled and the queued samples are written to the stream
+   * @return   void
+   */
+  static inaRawSample batch[BATCH_SIZE];  // Samples taken from the ring buffer
+  INA.poll();
+  uint8_t count = sampleRing.popBatch(batch, BATCH_SIZE);
+  encoder.encode(batch, count);
+}  // method loop()
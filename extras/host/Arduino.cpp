@@ -0,0 +1,82 @@
+/*!
+ @file Arduino.cpp
+
+ @brief Host implementation of the Arduino core functions declared in "Arduino.h"
+
+ The sketch is run as on a board, "setup()" once and then "loop()" forever. A sketch built for a
+ host ends the program itself, see the "Simulation" example. See "INA.h" for the license and author
+ information.
+*/
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <chrono>
+
+HardwareSerial Serial;  ///< The serial port of the sketch
+TwoWire        Wire;    ///< The first I2C bus
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+unsigned long micros() {
+  /*! @brief   Returns the microseconds since the program started, wrapping as on the boards */
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+  return ((uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}  // of function micros()
+unsigned long millis() {
+  /*! @brief   Returns the milliseconds since the program started, wrapping as on the boards */
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+  return ((uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}  // of function millis()
+void delay(unsigned long milliSeconds) {
+  /*! @brief   Returns straight away, the simulated devices don't need time to convert */
+  (void)milliSeconds;
+}  // of function delay()
+void delayMicroseconds(unsigned int microSeconds) {
+  /*! @brief   Returns straight away, the simulated bus needs no time for the I2C delay */
+  (void)microSeconds;
+}  // of function delayMicroseconds()
+void pinMode(uint8_t pin, uint8_t mode) {
+  /*! @brief   No pins on a host */
+  (void)pin;
+  (void)mode;
+}  // of function pinMode()
+int digitalRead(uint8_t pin) {
+  /*! @brief   No pins on a host, reads as the idle level of an ALERT line */
+  (void)pin;
+  return (1);
+}  // of function digitalRead()
+void noInterrupts() {}
+void interrupts() {}
+size_t Print::print(const char* text) {
+  /*! @brief   Write a string */
+  size_t count = 0;
+  while (*text) count += write((uint8_t)*text++);
+  return (count);
+}  // of method print()
+size_t Print::print(const long value) {
+  /*! @brief   Write a signed integer in decimal */
+  char text[24];
+  snprintf(text, sizeof(text), "%ld", value);
+  return (print(text));
+}  // of method print()
+size_t Print::print(const unsigned long value) {
+  /*! @brief   Write an unsigned integer in decimal */
+  char text[24];
+  snprintf(text, sizeof(text), "%lu", value);
+  return (print(text));
+}  // of method print()
+size_t Print::print(const double value, const int digits) {
+  /*! @brief   Write a floating point value with the given number of decimals */
+  char text[40];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return (print(text));
+}  // of method print()
+
+void setup();
+void loop();
+
+int main() {
+  /*! @brief   Runs the sketch as the Arduino core does */
+  setup();
+  for (;;) loop();
+}  // of function main()
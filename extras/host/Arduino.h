@@ -0,0 +1,103 @@
+// clang-format off
+/*!
+ @file Arduino.h
+
+ @brief Minimal emulation of the Arduino core for building the library on a host computer
+
+ @section Host_Arduino_intro_section Description
+
+ Only the parts of the Arduino core used by the library and the "Simulation" example are provided,
+ enough to compile and run them with a desktop compiler together with the "INA_Simulator" register
+ model, see "CMakeLists.txt" in this directory. Time is taken from the host's steady clock, the
+ delay functions return straight away and the serial port writes to the standard output.
+
+ See "INA.h" for the license and author information.
+
+@section Host_Arduino_versions Changelog
+
+| Version | Date       | Developer   | Comments
+| ------- | ---------- | ----------- | --------
+| 1.2.0   | 2026-10-14 | agent       | Initial coding
+*/
+#ifndef INA__Host_Arduino_h
+/*! Guard code definition to prevent multiple includes */
+#define INA__Host_Arduino_h
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool    boolean;  ///< Arduino name of the boolean type
+typedef uint8_t byte;     ///< Arduino name of an unsigned 8-bit value
+
+#define B11 3                                                 ///< Binary constant of "binary.h"
+#define B111 7                                                ///< Binary constant of "binary.h"
+#define B00000111 7                                           ///< Binary constant of "binary.h"
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)       ///< Read one bit
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))        ///< Set one bit
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))     ///< Clear one bit
+#define bitWrite(value, bit, on) ((on) ? bitSet(value, bit) : bitClear(value, bit))  ///< Write
+#define F(string) (string)                                    ///< Strings stay in RAM on a host
+#define PROGMEM                                               ///< No program memory on a host
+#define pgm_read_byte(address) (*(const uint8_t*)(address))   ///< Read a byte constant
+#define pgm_read_word(address) (*(const uint16_t*)(address))  ///< Read a word constant
+#define INPUT 0                                               ///< Pin mode
+#define OUTPUT 1                                              ///< Pin mode
+#define INPUT_PULLUP 2                                        ///< Pin mode
+#define FALLING 2                                             ///< Interrupt mode
+// clang-format on
+
+unsigned long micros();
+unsigned long millis();
+void          delay(unsigned long milliSeconds);
+void          delayMicroseconds(unsigned int microSeconds);
+void          pinMode(uint8_t pin, uint8_t mode);
+int           digitalRead(uint8_t pin);
+void          noInterrupts();
+void          interrupts();
+
+class Print {
+  /*!
+   * @class   Print
+   * @brief   Formatting subset of the Arduino "Print" class, the output goes to "write()"
+   */
+ public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t data) = 0;
+  size_t         print(const char* text);
+  size_t         print(const int value) { return (print((long)value)); }
+  size_t         print(const unsigned int value) { return (print((unsigned long)value)); }
+  size_t         print(const long value);
+  size_t         print(const unsigned long value);
+  size_t         print(const double value, const int digits = 2);
+  size_t         println() { return (print("\n")); }
+  size_t         println(const char* text) { return (print(text) + println()); }
+  template <typename T>
+  size_t println(const T value) {
+    /*! @brief Print a value followed by a newline */
+    return (print(value) + println());
+  }  // of method println()
+};   // of class Print
+class Stream : public Print {
+  /*!
+   * @class   Stream
+   * @brief   Input side of the Arduino "Stream" class, there never is any input
+   */
+ public:
+  virtual int available() { return (0); }
+  virtual int read() { return (-1); }
+};  // of class Stream
+class HardwareSerial : public Stream {
+  /*!
+   * @class   HardwareSerial
+   * @brief   Serial port writing to the standard output
+   */
+ public:
+  void   begin(const unsigned long speed) { (void)speed; }
+  size_t write(const uint8_t data) override { return (putchar(data) == EOF ? 0 : 1); }
+  operator bool() const { return (true); }
+};  // of class HardwareSerial
+extern HardwareSerial Serial;  ///< The serial port of the sketch
+#endif
@@ -0,0 +1,54 @@
+// clang-format off
+/*!
+ @file Wire.h
+
+ @brief Emulation of the Arduino "Wire" library for host builds
+
+ @section Host_Wire_intro_section Description
+
+ A host has no I2C bus, so "TwoWire" here finds no devices: every transfer is not acknowledged and
+ reads return no bytes. Programs built on a host talk to the "INA_Simulator" register model through
+ "setTransport()" instead, see "Arduino.h" in this directory.
+
+ See "INA.h" for the license and author information.
+
+@section Host_Wire_versions Changelog
+
+| Version | Date       | Developer   | Comments
+| ------- | ---------- | ----------- | --------
+| 1.2.0   | 2026-10-14 | agent       | Initial coding
+*/
+// clang-format on
+#ifndef INA__Host_Wire_h
+/*! Guard code definition to prevent multiple includes */
+#define INA__Host_Wire_h
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+  /*!
+   * @class   TwoWire
+   * @brief   I2C bus without any devices
+   */
+ public:
+  void    begin() {}
+  void    setClock(const uint32_t clock) { (void)clock; }
+  void    beginTransmission(const uint8_t address) { (void)address; }
+  uint8_t endTransmission(const bool sendStop = true) {
+    /*! @brief Send the queued bytes, the address is never acknowledged */
+    (void)sendStop;
+    return (2);  // Address not acknowledged
+  }  // of method endTransmission()
+  uint8_t requestFrom(const uint8_t address, const uint8_t count) {
+    /*! @brief Request bytes from a device, nobody answers */
+    (void)address;
+    (void)count;
+    return (0);
+  }  // of method requestFrom()
+  size_t write(const uint8_t data) override {
+    /*! @brief Queue a byte to send, it is discarded */
+    (void)data;
+    return (1);
+  }  // of method write()
+};   // of class TwoWire
+extern TwoWire Wire;  ///< The first I2C bus
+#endif
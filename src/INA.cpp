@@ -10,9 +10,32 @@
 #include <INA.h>   ///< Include the header definition
 #include <Wire.h>  ///< I2C Library definition
 #if defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266) || \
-    defined(STM32F1)
+    defined(STM32F1) || defined(__STM32F1__)
   #include <EEPROM.h>  ///< Include the EEPROM library for AVR-Boards
 #endif
+#if INA_COUNTERS
+  #define INA_COUNT(counter, value) _Counters.counter += (value)  ///< Add to a traffic counter
+#else
+  #define INA_COUNT(counter, value)  ///< Counters are compiled out
+#endif
+/*! typedef contains the LSB factors which only depend on the device type, see "INA_TYPE_LSB" */
+typedef struct {
+  uint16_t busVoltage_LSB;    ///< Bus LSB in uV * 100, 0 if computed with shifts (INA228)
+  uint16_t shuntVoltage_LSB;  ///< Shunt LSB in uV * 10, 0 if computed with shifts or none
+  uint8_t  powerFifths;       ///< Power LSB in fifths of the current LSB
+} inaTypeLSB;                 // of structure
+/*! LSB factors indexed by "ina_Type", kept in flash so that "inaDet" doesn't carry them */
+const inaTypeLSB INA_TYPE_LSB[] PROGMEM = {
+    {INA219_BUS_VOLTAGE_LSB, INA219_SHUNT_VOLTAGE_LSB, 100},        // INA219, 20 * current LSB
+    {INA226_BUS_VOLTAGE_LSB, INA226_SHUNT_VOLTAGE_LSB, 125},        // INA226, issue #66 multiplier
+    {0, 0, 16},                                                     // INA228, 3.2 * current LSB
+    {INA226_BUS_VOLTAGE_LSB, INA226_SHUNT_VOLTAGE_LSB, 125},        // INA230, same as INA226
+    {INA226_BUS_VOLTAGE_LSB, INA226_SHUNT_VOLTAGE_LSB, 125},        // INA231, same as INA226
+    {INA260_BUS_VOLTAGE_LSB, 0, 40},                                // INA260, fixed 10mW LSB
+    {INA3221_BUS_VOLTAGE_LSB, INA3221_SHUNT_VOLTAGE_LSB, 0},        // INA3221_0, no power reg.
+    {INA3221_BUS_VOLTAGE_LSB, INA3221_SHUNT_VOLTAGE_LSB, 0},        // INA3221_1, no power reg.
+    {INA3221_BUS_VOLTAGE_LSB, INA3221_SHUNT_VOLTAGE_LSB, 0},        // INA3221_2, no power reg.
+    {0, 0, 100}};                                                   // INA_UNKNOWN
 inaDet::inaDet() {}  ///< constructor for INA Detail class
 inaDet::inaDet(inaEEPROM &inaEE) {
   /*! @brief     INA Detail Class Constructor (Overloaded)
@@ -23,44 +46,37 @@ inaDet::inaDet(inaEEPROM &inaEE) {
   address       = inaEE.address;
   maxBusAmps    = inaEE.maxBusAmps;
   microOhmR     = inaEE.microOhmR;
+  bus           = inaEE.bus;
+  muxChannel    = inaEE.muxChannel;
   current_LSB   = (uint64_t)maxBusAmps * 1000000000 / 32767;  // Get the best possible LSB in nA
-  power_LSB     = (uint32_t)20 * current_LSB;                 // Default multiplier per device
+  adcRange      = 0;                                          // Only used on the INA228
   switch (type) {
     case INA219:
       busVoltageRegister   = INA_BUS_VOLTAGE_REGISTER;
       shuntVoltageRegister = INA219_SHUNT_VOLTAGE_REGISTER;
       currentRegister      = INA219_CURRENT_REGISTER;
-      busVoltage_LSB       = INA219_BUS_VOLTAGE_LSB;
-      shuntVoltage_LSB     = INA219_SHUNT_VOLTAGE_LSB;
       break;
     case INA226:
     case INA230:
     case INA231:
-      power_LSB            = (uint32_t)25 * current_LSB;  // issue #66 corrected multiplier
       busVoltageRegister   = INA_BUS_VOLTAGE_REGISTER;
       shuntVoltageRegister = INA226_SHUNT_VOLTAGE_REGISTER;
       currentRegister      = INA226_CURRENT_REGISTER;
-      busVoltage_LSB       = INA226_BUS_VOLTAGE_LSB;
-      shuntVoltage_LSB     = INA226_SHUNT_VOLTAGE_LSB;
       break;
 
     case INA228:
-      power_LSB            = 0;  // TODO
+      current_LSB          = (uint64_t)maxBusAmps * 1000000000 / INA228_CURRENT_STEPS;  // 20 bits
       busVoltageRegister   = INA228_BUS_VOLTAGE_REGISTER;
-      busVoltage_LSB       = INA228_BUS_VOLTAGE_LSB;
       shuntVoltageRegister = INA228_SHUNT_VOLTAGE_REGISTER;
-
-      currentRegister  = INA226_CURRENT_REGISTER;
-      shuntVoltage_LSB = INA226_SHUNT_VOLTAGE_LSB;
+      currentRegister      = INA228_CURRENT_REGISTER;
+      adcRange = (uint32_t)maxBusAmps * microOhmR <= INA228_ADCRANGE_LIMIT;  // Use +-40.96mV
       break;
 
     case INA260:
       busVoltageRegister   = INA_BUS_VOLTAGE_REGISTER;
       shuntVoltageRegister = INA260_SHUNT_VOLTAGE_REGISTER;  // Register not present
       currentRegister      = INA260_CURRENT_REGISTER;
-      busVoltage_LSB       = INA260_BUS_VOLTAGE_LSB;
-      current_LSB          = 1250000;   // Fixed LSB of 1.25mv
-      power_LSB            = 10000000;  // Fixed multiplier per device
+      current_LSB          = 1250000;  // Fixed LSB of 1.25mv
       break;
     case INA3221_0:
     case INA3221_1:
@@ -68,10 +84,7 @@ inaDet::inaDet(inaEEPROM &inaEE) {
       busVoltageRegister   = INA_BUS_VOLTAGE_REGISTER;
       shuntVoltageRegister = INA3221_SHUNT_VOLTAGE_REGISTER;
       currentRegister      = 0;  // INA3221 has no current Reg
-      busVoltage_LSB       = INA3221_BUS_VOLTAGE_LSB;
-      shuntVoltage_LSB     = INA3221_SHUNT_VOLTAGE_LSB;
       current_LSB          = 0;  // INA3221 has no current reg.
-      power_LSB            = 0;  // INA3221 has no power reg.
       if (type == INA3221_1) {
         busVoltageRegister += 2;    // Reg for 2nd bus voltage
         shuntVoltageRegister += 2;  // Reg for 2nd shunt voltage
@@ -84,19 +97,50 @@ inaDet::inaDet(inaEEPROM &inaEE) {
       break;
   }  // of switch type
 }  // of constructor
-INA_Class::INA_Class(uint8_t expectedDevices) : _expectedDevices(expectedDevices) {
+uint16_t inaDet::shuntVoltage_LSB() const {
+  /*! @brief     Return the shunt voltage LSB of the device type
+      @return    LSB in uV * 10, 0 on devices where it is computed with shifts or not present */
+  uint8_t index = type < INA_UNKNOWN ? type : (uint8_t)INA_UNKNOWN;  // Unknown types share a row
+  return (pgm_read_word(&INA_TYPE_LSB[index].shuntVoltage_LSB));
+}  // of method shuntVoltage_LSB()
+uint16_t inaDet::busVoltage_LSB() const {
+  /*! @brief     Return the bus voltage LSB of the device type
+      @return    LSB in uV * 100, 0 on the INA228 where it is computed with shifts */
+  uint8_t index = type < INA_UNKNOWN ? type : (uint8_t)INA_UNKNOWN;  // Unknown types share a row
+  return (pgm_read_word(&INA_TYPE_LSB[index].busVoltage_LSB));
+}  // of method busVoltage_LSB()
+uint32_t inaDet::power_LSB() const {
+  /*! @brief     Return the power LSB, a fixed multiple of the current LSB on each device type
+      @return    Power LSB in nW */
+  uint8_t index = type < INA_UNKNOWN ? type : (uint8_t)INA_UNKNOWN;  // Unknown types share a row
+  return ((uint64_t)current_LSB * pgm_read_byte(&INA_TYPE_LSB[index].powerFifths) / 5);
+}  // of method power_LSB()
+INA_Class::INA_Class(uint8_t expectedDevices, const bool cacheDevices)
+    : _expectedDevices(expectedDevices), _cacheDevices(cacheDevices) {
   /*!
 @brief   Class constructor
 @details If called without a parameter or with a 0 value, then the constructor does nothing,
          but if a value is passed then using EEPROM is disabled and each INA-Device found
          has its data (inaEEPROM structure size) stored in a array dynamically allocated during
          library instatiation here. If there is not enough space then the pointer isn't init-
-         ialized and the program will abort later on. No error checking can be done here
+         ialized and the program will abort later on. No error checking can be done here. Once
+         "begin()" has found the devices the array is trimmed to the number actually found
 @param[in] expectedDevices Number of elements to initialize array to if non-zero
+@param[in] cacheDevices If true then the fully decoded "inaDet" structure of every device found
+           is kept in RAM after "begin()", so that switching between devices is a simple copy
+           rather than an EEPROM read and recomputation. This costs sizeof(inaDet) bytes per device
 */
   if (_expectedDevices) {
     _DeviceArray = new inaEEPROM[_expectedDevices];
-  }  // if-then use memory rather than EEPROM
+  }                 // if-then use memory rather than EEPROM
+  _WireBus[0] = INA_WireTransport(&Wire);  // The default bus is always searched, others are
+  _Bus[0]     = &_WireBus[0];              // added with addBus() or replaced by setTransport()
+  for (uint8_t i = 0; i < INA_MAX_BUSES; i++) {
+    if (i) _Bus[i] = nullptr;
+    _MuxAddress[i] = 0;          // No multiplexer, see addMux()
+    _MuxChannel[i] = UINT8_MAX;  // Multiplexer state unknown
+    _i2cDelay[i]   = I2C_DELAY;  // Default delay, see setI2CSpeed()
+  }                              // of for-next each bus
 }  // of class constructor
 INA_Class::~INA_Class() {
   /*!
@@ -104,114 +148,771 @@ INA_Class::~INA_Class() {
   @details If dynamic memory has been allocated for device storage rather than the default EEPROM,
            then that memory is freed here; otherwise the destructor does nothing
   */
+#if defined(ESP32)
+  stopTask();  // Stop the sampling task first, it uses the memory freed below
+  if (_Mutex != nullptr) vSemaphoreDelete(_Mutex);
+#endif
   if (_expectedDevices) { delete[] _DeviceArray; }  // if-then use memory rather than EEPROM
+  delete[] _DeviceCache;                             // Free the decoded cache, if allocated
+  delete[] _DeviceState;                             // Free the runtime state, if allocated
+  delete _Queue;                                     // Free the async transfer queue, if allocated
+  delete[] _Samples;                                 // Free the sample slots, if allocated
+  delete[] _PollOrder;                               // Free the device order, if allocated
+  delete[] _Accumulators;                            // Free the integrators, if allocated
+  delete[] _Filters;                                 // Free the filters, if allocated
+  delete[] _Ranges;                                  // Free the auto-ranging state, if allocated
+  delete[] _Statistics;                              // Free the statistics, if allocated
+  delete[] _Alerts;                                  // Free the alert dispatch state, if allocated
+#if !(defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266) || \
+      defined(__STM32F1__))
+  delete[] _EEPROMEmulation;  // Free the device storage, if allocated
+#endif
 }  // of class destructor
+INA_Transport &INA_Class::wire() const {
+  /*! @brief     Return the I2C bus of the currently loaded device
+      @details   If the device is behind a multiplexer the multiplexer is switched to the channel of
+                 the device first, but only when a different channel is currently selected
+      @return    Reference to the transport of the bus the device is attached to */
+  uint8_t        b   = ina.bus < _BusCount ? ina.bus : 0;
+  INA_Transport &bus = *_Bus[b];
+  if (_MuxAddress[b] && _MuxChannel[b] != ina.muxChannel) {
+    bus.beginTransmission(_MuxAddress[b]);  // Select the channel, 0 switches all channels off
+    bus.write(ina.muxChannel ? (uint8_t)(1 << (ina.muxChannel - 1)) : (uint8_t)0);
+    bus.endTransmission();
+    INA_COUNT(i2cTransactions, 1);
+    INA_COUNT(i2cBytes, 1);
+    _MuxChannel[b] = ina.muxChannel;
+  }  // of if-then multiplexer needs switching
+  return (bus);
+}  // of method wire()
+inaState *INA_Class::pointerState(const uint8_t deviceAddress) const {
+  /*! @brief     Return the state used to track the register pointer of a device
+      @details   Tracking is only done for the currently loaded device, I2C traffic to any other
+                 address (such as during enumeration in begin()) always writes the pointer
+      @param[in] deviceAddress I2C address of the device being accessed
+      @return    Pointer to the state structure or nullptr */
+  if (deviceAddress != ina.address) return (nullptr);
+  return (currentState());
+}  // of method pointerState()
+bool INA_Class::setPointer(const uint8_t addr, const uint8_t deviceAddress) const {
+  /*! @brief     Point the device at a register ahead of a read
+      @details   The INA devices keep the last register pointer written, so the pointer write and
+                 the delay after it are skipped when the device already points at the register. A
+                 pointer write which wasn't acknowledged leaves the pointer unknown
+      @param[in] addr Register to point to
+      @param[in] deviceAddress I2C address of the device
+      @return    "true" if the device points at the register */
+  inaState *state = pointerState(deviceAddress);
+  if (state != nullptr && state->lastPointer == addr) return (true);  // Already pointing to it
+  uint8_t  attempt = 0;
+  bool     success;
+  uint32_t start;
+  do {
+    start   = transferStart();
+    wire().beginTransmission(deviceAddress);        // Address the I2C device
+    wire().write(addr);                             // Send register address to read
+    success = wire().endTransmission() == 0;        // Close transmission, 0 if acknowledged
+    if (busDelay()) delayMicroseconds(busDelay());  // delay required for sync
+    INA_COUNT(i2cTransactions, 1);
+    INA_COUNT(i2cBytes, 1);
+    INA_COUNT(delayMicros, busDelay());
+  } while (retryTransfer(deviceAddress, success, start, attempt));
+  if (state != nullptr) state->lastPointer = success ? addr : UINT8_MAX;
+  return (success);
+}  // of method setPointer()
+uint32_t INA_Class::transferStart() const {
+  /*! @brief     Return the start time of an I2C transfer for the statistics
+      @details   micros() is only called while statistics are kept, see "setStatistics()"
+      @return    micros() value, 0 when no statistics are kept */
+  return (_Statistics != nullptr ? micros() : 0);
+}  // of method transferStart()
+bool INA_Class::retryTransfer(const uint8_t deviceAddress, const bool success,
+                              const uint32_t startMicros, uint8_t &attempt) const {
+  /*! @brief     Account for an I2C transfer just made and decide whether to repeat it
+      @details   Transfers to the currently loaded device are counted and timed in the statistics of
+                 its physical device, failed ones are repeated up to the number of times set with
+                 "setI2CRetries()". Traffic to any other address, such as the search for devices
+                 in "begin()", is neither counted nor repeated
+      @param[in] deviceAddress I2C address the transfer went to
+      @param[in] success Set if the device acknowledged and returned all bytes requested
+      @param[in] startMicros Value returned by "transferStart()" before the transfer
+      @param[in,out] attempt Number of repeats made so far, incremented on a repeat
+      @return    "true" if the transfer is to be repeated */
+  if (deviceAddress != ina.address || _currentINA >= _DeviceCount) return (false);
+  bool repeat = !success && attempt < _i2cRetries;
+  if (repeat) attempt++;
+  if (_Statistics == nullptr || _DeviceState == nullptr) return (repeat);
+  inaStatistics &stats   = _Statistics[_DeviceState[_currentINA].chip];
+  uint32_t       latency = micros() - startMicros;
+  uint8_t        bucket  = 0;
+  for (uint32_t limit = 32; latency >= limit && bucket < INA_LATENCY_BUCKETS - 1; limit <<= 1) {
+    bucket++;
+  }  // of for-next each duration class
+  stats.transfers++;
+  stats.histogram[bucket]++;
+  stats.sumMicros += latency;
+  if (latency > stats.maxMicros) stats.maxMicros = latency;
+  if (!success) stats.nacks++;
+  if (repeat) stats.retries++;
+  return (repeat);
+}  // of method retryTransfer()
+uint8_t INA_Class::readError() const {
+  /*! @brief     Flag a register read which failed after all retries, see "readFailed()"
+      @return    0, the value returned by the failed read */
+  _readError = true;
+  return (0);
+}  // of method readError()
 int16_t INA_Class::readWord(const uint8_t addr, const uint8_t deviceAddress) const {
   /*! @brief     Read one word (2 bytes) from the specified I2C address
-      @details   Standard I2C protocol is used, but a delay of I2C_DELAY microseconds has been
-                 added to let the INAxxx devices have sufficient time to get the return data ready
+      @details   Standard I2C protocol is used, but a delay (I2C_DELAY microseconds by default, see
+                 setI2CSpeed()) has been added to let the INAxxx devices have sufficient time to get
+                 the return data ready. The register pointer is only written when it has changed. A
+                 read which still fails after the retries returns 0 and is flagged for
+                 "readFailed()"
       @param[in] addr I2C address to read from
       @param[in] deviceAddress Address on the I2C device to read from
       @return    integer value read from the I2C device */
-  Wire.beginTransmission(deviceAddress);        // Address the I2C device
-  Wire.write(addr);                             // Send register address to read
-  Wire.endTransmission();                       // Close transmission
-  delayMicroseconds(I2C_DELAY);                 // delay required for sync
-  Wire.requestFrom(deviceAddress, (uint8_t)2);  // Request 2 consecutive bytes
-  return ((uint16_t)Wire.read() << 8) | Wire.read();
+  uint8_t  attempt = 0;
+  bool     success, pointed;
+  uint32_t start;
+  do {
+    pointed = setPointer(addr, deviceAddress);  // Address the register if necessary, retried
+    start   = transferStart();
+    success = wire().requestFrom(deviceAddress, (uint8_t)2) == 2;  // Request 2 bytes
+    INA_COUNT(i2cTransactions, 1);
+    INA_COUNT(i2cBytes, 2);
+  } while (retryTransfer(deviceAddress, success, start, attempt));
+  if (!success || !pointed) return (readError());
+  return ((uint16_t)wire().read() << 8) | wire().read();
 }  // of method readWord()
 int32_t INA_Class::read3Bytes(const uint8_t addr, const uint8_t deviceAddress) const {
   /*! @brief     Read 3 bytes from the specified I2C address
-      @details   Standard I2C protocol is used, but a delay of I2C_DELAY microseconds has been
-                 added to let the INAxxx devices have sufficient time to get the return data ready
+      @details   Standard I2C protocol is used, but a delay (I2C_DELAY microseconds by default, see
+                 setI2CSpeed()) has been added to let the INAxxx devices have sufficient time to get
+                 the return data ready. The register pointer is only written when it has changed. A
+                 read which still fails after the retries returns 0 and is flagged for
+                 "readFailed()"
       @param[in] addr I2C address to read from
       @param[in] deviceAddress Address on the I2C device to read from
       @return    integer value read from the I2C device */
-  Wire.beginTransmission(deviceAddress);        // Address the I2C device
-  Wire.write(addr);                             // Send register address to read
-  Wire.endTransmission();                       // Close transmission
-  delayMicroseconds(I2C_DELAY);                 // delay required for sync
-  Wire.requestFrom(deviceAddress, (uint8_t)3);  // Request 3 consecutive bytes
-  return ((uint32_t)Wire.read() << 16) | ((uint32_t)Wire.read() << 8) | ((uint32_t)Wire.read());
-}  // of method readWord()
+  uint8_t  attempt = 0;
+  bool     success, pointed;
+  uint32_t start;
+  do {
+    pointed = setPointer(addr, deviceAddress);  // Address the register if necessary, retried
+    start   = transferStart();
+    success = wire().requestFrom(deviceAddress, (uint8_t)3) == 3;  // Request 3 bytes
+    INA_COUNT(i2cTransactions, 1);
+    INA_COUNT(i2cBytes, 3);
+  } while (retryTransfer(deviceAddress, success, start, attempt));
+  if (!success || !pointed) return (readError());
+  INA_Transport &bus = wire();
+  return ((uint32_t)bus.read() << 16) | ((uint32_t)bus.read() << 8) | ((uint32_t)bus.read());
+}  // of method read3Bytes()
+uint64_t INA_Class::read5Bytes(const uint8_t addr, const uint8_t deviceAddress) const {
+  /*! @brief     Read 5 bytes from the specified I2C address
+      @details   Used for the 40-bit accumulator registers of the INA228, see read3Bytes()
+      @param[in] addr I2C address to read from
+      @param[in] deviceAddress Address on the I2C device to read from
+      @return    integer value read from the I2C device */
+  uint8_t  attempt = 0;
+  bool     success, pointed;
+  uint32_t start;
+  do {
+    pointed = setPointer(addr, deviceAddress);  // Address the register if necessary, retried
+    start   = transferStart();
+    success = wire().requestFrom(deviceAddress, (uint8_t)5) == 5;  // Request 5 bytes
+    INA_COUNT(i2cTransactions, 1);
+    INA_COUNT(i2cBytes, 5);
+  } while (retryTransfer(deviceAddress, success, start, attempt));
+  if (!success || !pointed) return (readError());
+  INA_Transport &bus   = wire();
+  uint64_t       value = 0;
+  for (uint8_t i = 0; i < 5; i++) value = (value << 8) | (uint8_t)bus.read();  // MSB first
+  return (value);
+}  // of method read5Bytes()
+bool INA_Class::readRegisters(const uint8_t registers[], const uint8_t count, const uint8_t width,
+                              uint32_t buffer[], const uint8_t deviceAddress) const {
+  /*! @brief     Read a list of registers from a device in one burst
+      @details   None of the supported devices documents an auto-incrementing register pointer on
+                 reads, so each register is still addressed, but the pointer write and the read of
+                 each register are joined with a repeated start and the I2C delay is only done once
+                 for the whole burst instead of once per register. The first pointer write is
+                 skipped if the device already points at the first register. A pointer write only
+                 counts as failed when it wasn't acknowledged, as some cores return other non-zero
+                 values for a write held open for the repeated start, and the register isn't read.
+                 A register which still can't be read after the retries is stored as 0 and flagged
+                 for "readFailed()"
+      @param[in] registers Array of "count" register addresses to read, in order
+      @param[in] count Number of registers to read
+      @param[in] width Register width in bytes, 2 or 3
+      @param[out] buffer Array of at least "count" elements to store the register contents in
+      @param[in] deviceAddress I2C address of the device
+      @return    "true" if all registers were read */
+  inaState *state = pointerState(deviceAddress);
+  bool      all   = true;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t  attempt = 0;
+    bool     success;
+    uint32_t start;
+    do {
+      start        = transferStart();
+      bool written = true;
+      if (i > 0 || attempt > 0 || state == nullptr || state->lastPointer != registers[0]) {
+        wire().beginTransmission(deviceAddress);         // Address the I2C device
+        wire().write(registers[i]);                      // Send register address to read
+        uint8_t status = wire().endTransmission(false);  // Repeated start, keep the bus
+        written        = status != INA_I2C_ADDRESS_NACK && status != INA_I2C_DATA_NACK;
+        if (i == 0 && busDelay()) delayMicroseconds(busDelay());  // required, once per burst
+        INA_COUNT(i2cTransactions, 1);
+        INA_COUNT(i2cBytes, 1);
+        INA_COUNT(delayMicros, i == 0 ? busDelay() : 0);
+      }  // of if-then pointer needs to be written
+      success = written && wire().requestFrom(deviceAddress, width) == width;  // Register bytes
+      INA_COUNT(i2cTransactions, 1);
+      INA_COUNT(i2cBytes, width);
+    } while (retryTransfer(deviceAddress, success, start, attempt));
+    uint32_t value = 0;
+    if (success) {
+      for (uint8_t j = 0; j < width; j++) value = (value << 8) | (uint8_t)wire().read();  // MSB 1st
+    } else {
+      readError();  // Flag the failure, the register is stored as 0
+      all = false;
+    }  // of if-then-else register read
+    buffer[i] = value;
+    if (state != nullptr) state->lastPointer = success ? registers[i] : UINT8_MAX;
+  }  // of for-next each register
+  return (all);
+}  // of method readRegisters()
 void INA_Class::writeWord(const uint8_t addr, const uint16_t data,
                           const uint8_t deviceAddress) const {
   /*! @brief     Write 2 bytes to the specified I2C address
-      @details   Standard I2C protocol is used, but a delay of I2C_DELAY microseconds has been
-                 added to let the INAxxx devices have sufficient time to process the data
+      @details   Standard I2C protocol is used, but a delay (I2C_DELAY microseconds by default, see
+                 setI2CSpeed()) has been added to let the INAxxx devices have sufficient time to
+                 process the data. A zero delay skips the wait. The write leaves the device's
+                 register pointer at "addr"
       @param[in] addr I2C address to write to
       @param[in] data 2 Bytes to write to the device
       @param[in] deviceAddress Address on the I2C device to write to */
-  Wire.beginTransmission(deviceAddress);  // Address the I2C device
-  Wire.write(addr);                       // Send register address to write
-  Wire.write((uint8_t)(data >> 8));       // Write the first (MSB) byte
-  Wire.write((uint8_t)data);              // and then the second byte
-  Wire.endTransmission();                 // Close transmission and actually send data
-  delayMicroseconds(I2C_DELAY);           // delay required for sync
+  uint8_t  attempt = 0;
+  bool     success;
+  uint32_t start;
+  do {
+    start   = transferStart();
+    wire().beginTransmission(deviceAddress);        // Address the I2C device
+    wire().write(addr);                             // Send register address to write
+    wire().write((uint8_t)(data >> 8));             // Write the first (MSB) byte
+    wire().write((uint8_t)data);                    // and then the second byte
+    success = wire().endTransmission() == 0;        // Close transmission and actually send data
+    if (busDelay()) delayMicroseconds(busDelay());  // delay required for sync
+    INA_COUNT(i2cTransactions, 1);
+    INA_COUNT(i2cBytes, 3);
+    INA_COUNT(delayMicros, busDelay());
+  } while (retryTransfer(deviceAddress, success, start, attempt));
+  inaState *state = pointerState(deviceAddress);
+  if (state != nullptr) state->lastPointer = success ? addr : UINT8_MAX;
 }  // of method writeWord()
+uint32_t INA_Class::readBusRegister() const {
+  /*! @brief     Read the bus voltage register of the currently loaded device
+      @details   The value is returned right-aligned, i.e. with any unused low-order bits shifted
+                 out. No triggered-mode processing is done here, that is left to the caller
+      @return    Raw bus measurement */
+  uint32_t raw;
+  if (ina.type == INA228) {
+    raw = read3Bytes(ina.busVoltageRegister, ina.address) >> 4;  // 20 MSB bits are the value
+  } else {
+    raw = (uint16_t)readWord(ina.busVoltageRegister, ina.address);  // Unsigned, bit 15 is data
+    if (ina.type == INA3221_0 || ina.type == INA3221_1 || ina.type == INA3221_2 ||
+        ina.type == INA219) {
+      raw = raw >> 3;  // INA219 & INA3221 - the 3 LSB unused, so shift right
+    }                  // of if-then an INA219 or INA3221
+  }                    // if-then a 3byte bus voltage buffer
+  return (raw);
+}  // of method readBusRegister()
+int32_t INA_Class::readShuntRegister() const {
+  /*! @brief     Read the shunt voltage register of the currently loaded device
+      @details   The value is returned right-aligned and sign-extended. Not valid for the INA260,
+                 which has no shunt register. No triggered-mode processing is done here
+      @return    Raw shunt measurement */
+  int32_t raw;
+  if (ina.type == INA228)  // INA228 has 24 bit accuracy
+  {
+    raw = read3Bytes(ina.shuntVoltageRegister, ina.address);  // Get the raw value from register
+    // The number is two's complement, so if negative we need to pad when shifting //
+    if (raw & 0x800000) {
+      raw = (raw >> 4) | 0xFFF00000;  // first 12 bits are "1"
+    } else {
+      raw = raw >> 4;
+    }  // if-then negative
+  } else {
+    raw = readWord(ina.shuntVoltageRegister, ina.address);  // Get the raw value from register
+    if (ina.type == INA3221_0 || ina.type == INA3221_1 ||
+        ina.type == INA3221_2)  // Doesn't use 3 LSB
+    {
+      raw = raw >> 3;  // shift over 3 bits, datatype is "int" so shifts in sign bits
+    }                  // of if-then we need to shift INA3221 reading over
+  }                    // if-then-else a 24 bit register
+  return (raw);
+}  // of method readShuntRegister()
+int32_t INA_Class::readCurrentRegister() const {
+  /*! @brief     Read the current register of the currently loaded device
+      @details   Not valid for the INA3221, which has no current register. The 20 bit INA228 value
+                 is returned right-aligned and sign-extended
+      @return    Raw current register contents */
+  if (ina.type == INA228) {
+    int32_t raw = read3Bytes(ina.currentRegister, ina.address);
+    return ((raw & 0x800000) ? (raw >> 4) | 0xFFF00000 : raw >> 4);  // 20 MSB bits are the value
+  }  // of if-then an INA228
+  return ((int16_t)readWord(ina.currentRegister, ina.address));
+}  // of method readCurrentRegister()
+uint32_t INA_Class::readPowerRegister() const {
+  /*! @brief     Read the power register of the currently loaded device
+      @details   Not valid for the INA3221, which has no power register. The power is unsigned
+      @return    Raw power register contents */
+  if (ina.type == INA228) return (read3Bytes(INA228_POWER_REGISTER, ina.address));  // 24 bits
+  return ((uint16_t)readWord(INA_POWER_REGISTER, ina.address));
+}  // of method readPowerRegister()
+uint8_t INA_Class::configAddress() const {
+  /*! @brief     Return the register holding the operating mode, averaging and conversion times
+      @details   This is the configuration register on all devices except the INA228, where these
+                 settings are in the ADC configuration register
+      @return    Register address */
+  return (ina.type == INA228 ? INA228_ADC_CONFIG_REGISTER : INA_CONFIGURATION_REGISTER);
+}  // of method configAddress()
+uint8_t INA_Class::maskAddress() const {
+  /*! @brief     Return the register holding the alert settings
+      @details   This is the mask/enable register on the INA226-style devices and the diagnostic and
+                 alert register on the INA228
+      @return    Register address */
+  return (ina.type == INA228 ? INA228_DIAG_ALERT_REGISTER : INA_MASK_ENABLE_REGISTER);
+}  // of method maskAddress()
+void INA_Class::triggerConversion() const {
+  /*! @brief     Start the next conversion on the currently loaded device
+      @details   Writing the configuration register back to a device in triggered mode starts a
+                 new conversion. The value comes from the shadow copy, so this is a single write.
+                 The caller decides whether the device is in triggered mode */
+  writeWord(configAddress(), getConfiguration(), ina.address);  // Write to trigger next
+}  // of method triggerConversion()
+inaState *INA_Class::currentState() const {
+  /*! @brief     Return the runtime state of the physical device of the currently loaded device
+      @details   All channels of an INA3221 share the state of the first channel. If the state array
+                 hasn't been allocated yet (during enumeration) a null pointer is returned
+      @return    Pointer to the state structure or nullptr */
+  if (_DeviceState == nullptr || _currentINA >= _DeviceCount) return nullptr;
+  return (&_DeviceState[_DeviceState[_currentINA].chip]);
+}  // of method currentState()
+uint16_t INA_Class::getConfiguration() const {
+  /*! @brief     Return the configuration register of the currently loaded device
+      @details   The shadow copy is used when available, otherwise the device is read
+      @return    Configuration register contents */
+  inaState *state = currentState();
+  if (state != nullptr) return (state->configRegister);
+  return (readWord(configAddress(), ina.address));
+}  // of method getConfiguration()
+void INA_Class::setConfiguration(const uint16_t configRegister) {
+  /*! @brief     Write the configuration register of the currently loaded device
+      @details   The shadow copy is updated at the same time
+      @param[in] configRegister New configuration register contents */
+  writeWord(configAddress(), configRegister, ina.address);  // Save new value to device
+  inaState *state = currentState();
+  if (state != nullptr) {
+    state->configRegister = configRegister;
+    state->cycleMicros    = conversionMicros(configRegister);  // Settings may have changed
+  }  // of if-then state available
+}  // of method setConfiguration()
+uint32_t INA_Class::conversionMicros(const uint16_t configRegister) const {
+  /*! @brief     Compute how long the currently loaded device takes to produce one result
+      @details   Decoded from the conversion times and averaging in the configuration register and
+                 the operating mode, only the enabled bus and shunt conversions are counted. An
+                 INA3221 converts its 3 channels in turn before the result is ready
+      @param[in] configRegister Configuration (ADC_CONFIG on the INA228) register contents
+      @return    Microseconds per result, 0 if the device is powered down or unknown */
+  static const uint16_t inaTimes[8]{140, 204, 332, 588, 1100, 2116, 4156, 8244};
+  static const uint16_t ina228Times[8]{50, 84, 150, 280, 540, 1052, 2074, 4120};
+  static const uint16_t ina219Times[4]{84, 148, 276, 532};
+  uint32_t busTime, shuntTime, averages;
+  uint8_t  code;
+  switch (ina.type) {
+    case INA219:  // 4-bit BADC and SADC fields, averages included in the time
+      code      = (configRegister >> 7) & 0xF;
+      busTime   = (code & 8) ? (uint32_t)532 << (code & 7) : ina219Times[code & 3];
+      code      = (configRegister >> 3) & 0xF;
+      shuntTime = (code & 8) ? (uint32_t)532 << (code & 7) : ina219Times[code & 3];
+      averages  = 1;
+      break;
+    case INA228:
+      busTime   = ina228Times[(configRegister >> 9) & 7];
+      shuntTime = ina228Times[(configRegister >> 6) & 7];
+      code      = configRegister & 7;
+      averages  = code < 4 ? (uint32_t)1 << (2 * code) : (uint32_t)1 << (code + 3);
+      break;
+    case INA226:
+    case INA230:
+    case INA231:
+    case INA260:
+    case INA3221_0:
+    case INA3221_1:
+    case INA3221_2:
+      busTime   = inaTimes[(configRegister >> 6) & 7];
+      shuntTime = inaTimes[(configRegister >> 3) & 7];
+      code      = (configRegister >> 9) & 7;
+      averages  = code < 4 ? (uint32_t)1 << (2 * code) : (uint32_t)1 << (code + 3);
+      if (ina.type >= INA3221_0) averages *= 3;  // All 3 channels are converted
+      break;
+    default: return (0);
+  }  // of switch type
+  if (!bitRead(ina.operatingMode, 1)) busTime = 0;    // Bus not converted
+  if (!bitRead(ina.operatingMode, 0)) shuntTime = 0;  // Shunt not converted
+  return ((busTime + shuntTime) * averages);
+}  // of method conversionMicros()
+void INA_Class::scheduleNext(inaState &state, const uint32_t tick) const {
+  /*! @brief     Set when the next result of a device is due after a conversion started at "tick"
+      @details   The device is checked an eighth of the cycle early, which covers the tolerance of
+                 the device oscillator. If it isn't ready then it is checked on each following
+                 "poll()", so the reads lock onto the device's own timing. With timed reads the
+                 result is due at the predicted completion instead, see "setTimedReads()"
+      @param[in,out] state Runtime state of the physical device
+      @param[in] tick micros() value at which the conversion started */
+  if (_timedReads) {
+    state.dueTick = tick + predictedMicros(state);
+  } else {
+    state.dueTick = tick + state.cycleMicros - (state.cycleMicros >> 3);
+  }  // of if-then-else timed reads
+}  // of method scheduleNext()
+uint32_t INA_Class::predictedMicros(const inaState &state) const {
+  /*! @brief     Return the time a conversion of a device takes according to the timing model
+      @details   The nominal time from the configuration is scaled by the device's timing scale,
+                 which is either the uncalibrated default or the result of "calibrateTiming()"
+      @param[in] state Runtime state of the physical device
+      @return    Microseconds until the result is expected, 0 if the device isn't converting */
+  return ((uint32_t)(((uint64_t)state.cycleMicros * state.timingScale) / INA_TIMING_UNITY));
+}  // of method predictedMicros()
+uint16_t INA_Class::getMaskEnable() const {
+  /*! @brief     Return the mask/enable register of the currently loaded device
+      @details   The shadow copy is used when available, otherwise the device is read. Only valid
+                 for devices which have the INA226-style mask/enable register
+      @return    Mask/enable register contents */
+  inaState *state = currentState();
+  if (state != nullptr) return (state->maskRegister);
+  return (readWord(maskAddress(), ina.address));
+}  // of method getMaskEnable()
+void INA_Class::setMaskEnable(const uint16_t maskRegister) {
+  /*! @brief     Write the mask/enable register of the currently loaded device
+      @details   The shadow copy is updated at the same time
+      @param[in] maskRegister New mask/enable register contents */
+  writeWord(maskAddress(), maskRegister, ina.address);  // Write register back
+  inaState *state = currentState();
+  if (state != nullptr) state->maskRegister = maskRegister;
+}  // of method setMaskEnable()
+uint16_t INA_Class::busToMilliVolts(const uint32_t raw) const {
+  /*! @brief     Convert a raw bus reading of the currently loaded device into millivolts
+      @param[in] raw Raw bus reading as returned by readBusRegister()
+      @return    Bus millivolts */
+  uint32_t busVoltage;
+  if (ina.type == INA228) {
+    busVoltage = (raw * 25) >> 7;  // 20 bits with an LSB of 195.3125uV = 25/128 mV
+  } else {
+    busVoltage = raw * ina.busVoltage_LSB() / 100;  // conversion to get mV
+  }                                               // if-then-else an INA228
+  return (busVoltage);
+}  // of method busToMilliVolts()
+int32_t INA_Class::shuntToMicroVolts(const int32_t raw) const {
+  /*! @brief     Convert a raw shunt reading of the currently loaded device into microvolts
+      @details   Not valid for the INA260, which has no shunt register
+      @param[in] raw Raw shunt reading as returned by readShuntRegister()
+      @return    Shunt microvolts */
+  if (ina.type == INA228) {  // LSB is 312.5nV = 5/16 uV, or 78.125nV = 5/64 uV with ADCRANGE
+    return ((raw * 5) >> (ina.adcRange ? 6 : 4));
+  }  // of if-then an INA228
+  return (raw * ina.shuntVoltage_LSB() / 10);
+}  // of method shuntToMicroVolts()
+int32_t INA_Class::currentToMicroAmps(const int32_t raw) const {
+  /*! @brief     Convert a raw current reading of the currently loaded device into microamps
+      @details   For devices with a current register the raw value is that register's contents, for
+                 the INA3221 which has no such register the raw value is the shunt reading
+      @param[in] raw Raw current register or, for the INA3221, raw shunt register contents
+      @return    Microamps */
+  if (ina.type == INA3221_0 || ina.type == INA3221_1 || ina.type == INA3221_2) {
+    return ((int64_t)shuntToMicroVolts(raw) * ((int64_t)1000000 / (int64_t)ina.microOhmR));
+  }  // of if-then an INA3221
+  if (ina.type == INA228 && _DeviceState != nullptr && _currentINA < _DeviceCount) {
+    return (applyScale(raw, _DeviceState[_currentINA].currentScale));  // Precomputed factor
+  }  // of if-then an INA228 after begin()
+  return ((int64_t)raw * (int64_t)ina.current_LSB / (int64_t)1000);
+}  // of method currentToMicroAmps()
+int64_t INA_Class::powerToMicroWatts(const uint32_t raw) const {
+  /*! @brief     Convert a raw power reading of the currently loaded device into microwatts
+      @details   Uses the factor precomputed in begin() when available. The power is unsigned, the
+                 caller applies the sign of the current
+      @param[in] raw Raw power register contents as returned by readPowerRegister()
+      @return    Microwatts */
+  if (_DeviceState != nullptr && _currentINA < _DeviceCount) {
+    return (applyWideScale(raw, _DeviceState[_currentINA].powerScale));  // Precomputed factor
+  }  // of if-then scales are available
+  return ((int64_t)raw * (int64_t)ina.power_LSB() / (int64_t)1000);
+}  // of method powerToMicroWatts()
+inaScale INA_Class::makeScale(const uint32_t numerator, const uint32_t denominator,
+                              const uint8_t rawBits) const {
+  /*! @brief     Compute a fixed-point scale factor approximating numerator / denominator
+      @details   The shift is made as large as possible while (raw * mult) still fits into 32 bits
+                 for raw values of up to "rawBits" bits including sign. Raw values wider than 16
+                 bits would leave too few bits for the multiplier, so those are split into two parts
+                 which are each multiplied in 32 bits by a 19-bit multiplier, see applyWideScale().
+                 The division is only done here, once per device
+      @param[in] numerator Numerator of the ratio
+      @param[in] denominator Denominator of the ratio
+      @param[in] rawBits Number of significant bits of the raw value to be scaled
+      @return    Scale factor structure */
+  inaScale scale{0, 0, rawBits > 16};
+  if (numerator == 0 || denominator == 0) return (scale);  // Device doesn't have this value
+  uint32_t limit = scale.wide ? (uint32_t)1 << 19 : (uint32_t)1 << (31 - rawBits);
+  while (scale.shift < 31 && ((uint64_t)numerator << (scale.shift + 1)) / denominator < limit) {
+    scale.shift++;
+  }  // of while-loop the multiplier can be doubled
+  scale.mult = ((uint64_t)numerator << scale.shift) / denominator;
+  return (scale);
+}  // of method makeScale()
+int32_t INA_Class::applyScale(const int32_t raw, const inaScale &scale) const {
+  /*! @brief     Apply a fixed-point scale factor computed by makeScale() to a raw value
+      @param[in] raw Raw register value
+      @param[in] scale Scale factor
+      @return    Scaled value */
+  if (scale.wide) return ((int32_t)applyWideScale(raw, scale));
+  return ((raw * (int32_t)scale.mult) >> scale.shift);
+}  // of method applyScale()
+int64_t INA_Class::applyWideScale(const int32_t raw, const inaScale &scale) const {
+  /*! @brief     Apply a fixed-point scale factor to a raw value of up to 24 bits
+      @details   The raw value is split at bit 12 so that both partial products fit into 32 bits
+                 with a multiplier of up to 19 bits, the exact product is then rebuilt with a shift
+                 and an add. No 64-bit multiply or divide is needed
+      @param[in] raw Raw register value, up to 24 bits unsigned or 24 bits including sign
+      @param[in] scale Scale factor computed by makeScale()
+      @return    Scaled value */
+  int32_t  high = raw >> 12;    // Arithmetic shift keeps the sign
+  uint32_t low  = raw & 0xFFF;  // Always positive
+  int64_t  product =
+      ((int64_t)(high * (int32_t)scale.mult) << 12) + (int64_t)(low * scale.mult);
+  return (product >> scale.shift);
+}  // of method applyWideScale()
+void INA_Class::computeScales(const uint8_t deviceNumber) {
+  /*! @brief     Precompute the fixed-point scale factors used by convertSamples() for a device
+      @details   The factors give the same results as busToMilliVolts(), shuntToMicroVolts() and
+                 currentToMicroAmps() to within rounding of the last digit. They need to be
+                 recomputed whenever the calibration of the device changes. The shunt of an
+                 auto-ranged INA228 is scaled from the finer range, see "rangedShunt()"
+      @param[in] deviceNumber Device to compute the factors for, must be the loaded device */
+  inaState &state = _DeviceState[deviceNumber];
+  uint8_t   bits  = (ina.type == INA228) ? 20 : 16;  // INA228 has 20 bit registers
+  state.type      = ina.type;
+  state.powerScale = makeScale(ina.power_LSB(), 1000, 24);  // Power register is up to 24 bits
+  if (ina.type == INA228) {
+    state.busScale = makeScale(25, 128, bits);  // 195.3125uV LSB
+  } else {
+    state.busScale = makeScale(ina.busVoltage_LSB(), 100, bits);
+  }  // if-then-else an INA228
+  switch (ina.type) {
+    case INA228:  // 312.5nV or 78.125nV shunt LSB depending on ADCRANGE
+      if (_Ranges != nullptr && _Ranges[deviceNumber].enabled) {
+        state.shuntScale = makeScale(5, 64, bits + 2);  // Always in units of the finer range
+      } else {
+        state.shuntScale = makeScale(5, ina.adcRange ? 64 : 16, bits);
+      }  // of if-then-else auto-ranged
+      state.currentScale = makeScale(ina.current_LSB, 1000, bits);
+      break;
+    case INA3221_0:
+    case INA3221_1:
+    case INA3221_2:  // No current register, compute from the shunt
+      state.shuntScale   = makeScale(ina.shuntVoltage_LSB(), 10, bits);
+      state.currentScale =
+          makeScale((uint32_t)ina.shuntVoltage_LSB() * 100000, ina.microOhmR, bits);
+      break;
+    case INA260:  // No shunt register, compute from the current and 2mOhm resistor
+      state.shuntScale   = makeScale(ina.current_LSB, 200000, bits);
+      state.currentScale = makeScale(ina.current_LSB, 1000, bits);
+      break;
+    default:
+      state.shuntScale   = makeScale(ina.shuntVoltage_LSB(), 10, bits);
+      state.currentScale = makeScale(ina.current_LSB, 1000, 16);
+  }  // of switch type
+}  // of method computeScales()
 void INA_Class::readInafromEEPROM(const uint8_t deviceNumber) {
   /*! @brief     Read INA device information from EEPROM
       @details   Retrieve the stored information for a device from EEPROM. Since this method is
                  private and access is controlled, no range error checking is performed
       @param[in] deviceNumber Index to device array */
-  if (deviceNumber == _currentINA || deviceNumber > _DeviceCount) return;  // Skip if correct device
+  if (deviceNumber == _currentINA || deviceNumber > _DeviceCount) {
+    INA_COUNT(cacheHits, 1);
+    return;  // Skip if correct device
+  }          // of if-then already loaded
+  if (_DeviceCache != nullptr && deviceNumber < _DeviceCount) {
+    ina         = _DeviceCache[deviceNumber];  // Already decoded, just copy from RAM
+    _currentINA = deviceNumber;
+    if (_Ranges != nullptr && _Ranges[deviceNumber].enabled) {
+      ina.adcRange = _Ranges[deviceNumber].fine;  // Shunt range in use, see setAutoRange()
+    }  // of if-then auto-ranged
+    INA_COUNT(cacheHits, 1);
+    return;
+  }  // of if-then device cache is active
+  INA_COUNT(eepromReads, 1);
   if (_expectedDevices == 0) {
 #if defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266) || (__STM32F1__)
-  #ifdef __STM32F1__                                          // STM32F1 has no built-in EEPROM
-    uint16_t  e   = deviceNumber * sizeof(inaEE);             // it uses flash memory to emulate
-    uint16_t *ptr = (uint16_t *)&inaEE;                       // "EEPROM" calls are uint16_t type
-    for (uint8_t n = sizeof(inaEE) + _EEPROM_offset; n; --n)  // Implement EEPROM.get template
+  #ifdef __STM32F1__  // STM32F1 has no built-in EEPROM, it uses flash memory to emulate it
+    uint16_t words[(sizeof(inaEE) + 1) / 2];  // "EEPROM" calls are uint16_t type
+    uint16_t e = _EEPROM_offset + deviceNumber * (sizeof(words) / 2);  // Record's first word
+    for (uint8_t n = 0; n < sizeof(words) / 2; n++)  // Implement EEPROM.get template
     {
-      EEPROM.read(e++, ptr++);  // for ina (inaDet type)
-    }                           // of for-next each byte
+      EEPROM.read(e + n, &words[n]);
+    }  // of for-next each word
+    memcpy(&inaEE, words, sizeof(inaEE));
   #else
-    EEPROM.get(_EEPROM_offset + (deviceNumber * sizeof(inaEE)), inaEE);  // Read EEPROM values
+    EEPROM.get(_EEPROM_offset + sizeof(inaHeader) + (deviceNumber * sizeof(inaEE)), inaEE);
   #endif
 #else
-    inaEE                          = _EEPROMEmulation[deviceNumber];
+    inaEE = _EEPROMEmulation[deviceNumber];
 #endif
   } else {
     inaEE = _DeviceArray[deviceNumber];
   }  // if-then-else use EEPROM
   _currentINA = deviceNumber;
   ina         = inaEE;  // see inaDet constructor
+  if (_Ranges != nullptr && _Ranges[deviceNumber].enabled) {
+    ina.adcRange = _Ranges[deviceNumber].fine;  // Shunt range in use, see setAutoRange()
+  }  // of if-then auto-ranged
 }  // of method readInafromEEPROM()
 void INA_Class::writeInatoEEPROM(const uint8_t deviceNumber) {
   /*! @brief     Write INA device information to EEPROM
-      @details   Write the stored information for a device from EEPROM. Since this method is
-                 private and access is controlled, no range error checking is performed
+      @details   Write the stored information for a device to EEPROM. Since this method is
+                 private and access is controlled, no range error checking is performed. With the
+                 device cache active and "setDeferredCommit()" set, only the cache is updated and
+                 the record is marked to be written by "commit()"
       @param[in] deviceNumber Index to device array */
   inaEE = ina;  // only save relevant part of ina to EEPROM
+  if (_DeviceCache != nullptr && deviceNumber < _DeviceCount) {
+    inaDet &cached    = _DeviceCache[deviceNumber];
+    bool    unchanged = sameRecord(cached, inaEE);  // Compare stored values against the new ones
+    cached            = inaEE;  // Re-decode into cache, see inaDet constructor
+    if (unchanged) return;      // Nothing to write if the configuration is the same
+    if (!_commitOnWrite && _DeviceState != nullptr) {  // Coalesce changes until commit()
+      _DeviceState[deviceNumber].recordDirty = true;
+      return;
+    }  // of if-then writes are deferred
+  }    // of if-then device cache is active
+  storeRecord(deviceNumber);
+}  // of method writeInatoEEPROM()
+void INA_Class::storeRecord(const uint8_t deviceNumber) {
+  /*! @brief     Write the "inaEE" record to the storage of a device, if it differs from the record
+                 already stored
+      @details   An unchanged record is neither written nor committed, so that only changes wear
+                 the EEPROM or flash
+      @param[in] deviceNumber Index to device array */
   if (_expectedDevices == 0) {
 #if defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266) || (__STM32F1__)
-  #ifdef __STM32F1__                                          // STM32F1 has no built-in EEPROM
-    uint16_t        e   = deviceNumber * sizeof(inaEE);       // it uses flash memory to emulate
-    const uint16_t *ptr = (const uint16_t *)&inaEE;           // "EEPROM" calls are uint16_t type
-    for (uint8_t n = sizeof(inaEE) + _EEPROM_offset; n; --n)  // Implement EEPROM.put template
+  #ifdef __STM32F1__  // STM32F1 has no built-in EEPROM, it uses flash memory to emulate it
+    uint16_t words[(sizeof(inaEE) + 1) / 2]{};  // "EEPROM" calls are uint16_t type
+    uint16_t e = _EEPROM_offset + deviceNumber * (sizeof(words) / 2);  // Record's first word
+    memcpy(words, &inaEE, sizeof(inaEE));
+    for (uint8_t n = 0; n < sizeof(words) / 2; n++)  // Implement EEPROM.put template
     {
-      EEPROM.update(e++, *ptr++);  // for ina (inaDet type)
-    }                              // for-next
+      EEPROM.update(e + n, words[n]);  // Only written if the word differs
+    }                                  // for-next each word
   #else
-    EEPROM.put(_EEPROM_offset + (deviceNumber * sizeof(inaEE)), inaEE);  // Write the structure
-    #ifdef ESP32
-    EEPROM.commit();                                                     // Force write to EEPROM when ESP32
-    #endif
+    uint16_t  e = _EEPROM_offset + sizeof(inaHeader) + (deviceNumber * sizeof(inaEE));
+    inaEEPROM stored;
+    EEPROM.get(e, stored);
+    if (sameRecord(stored, inaEE)) return;  // Nothing to write
+    EEPROM.put(e, inaEE);
+    _commitPending = true;
+    commitEEPROM();  // Force write unless writes are being batched
   #endif
 #else
+    if (deviceNumber >= _EmulationSize) {                     // Grow the storage when full
+      uint16_t size = _EmulationSize ? 2 * _EmulationSize : 8;  // doubling it each time
+      while (size <= deviceNumber) size *= 2;
+      inaEEPROM *grown = new inaEEPROM[size];
+      for (uint16_t i = 0; i < _EmulationSize; i++) grown[i] = _EEPROMEmulation[i];
+      delete[] _EEPROMEmulation;
+      _EEPROMEmulation = grown;
+      _EmulationSize   = size;
+    }  // of if-then storage is full
     _EEPROMEmulation[deviceNumber] = inaEE;
 #endif
   } else {
     _DeviceArray[deviceNumber] = inaEE;
   }  // if-then-else use EEPROM to store data
-}  // of method writeInatoEEPROM()
-void INA_Class::setI2CSpeed(const uint32_t i2cSpeed) const {
+}  // of method storeRecord()
+bool INA_Class::sameRecord(const inaEEPROM &stored, const inaEEPROM &record) const {
+  /*! @brief     Compare two device records field by field, the padding bits being undefined
+      @param[in] stored Record as stored
+      @param[in] record Record to compare with
+      @return    "true" if both records hold the same values */
+  return (stored.type == record.type && stored.operatingMode == record.operatingMode &&
+          stored.address == record.address && stored.maxBusAmps == record.maxBusAmps &&
+          stored.microOhmR == record.microOhmR && stored.bus == record.bus &&
+          stored.muxChannel == record.muxChannel);
+}  // of method sameRecord()
+void INA_Class::setDeferredCommit(const bool deferred) {
+  /*!
+  @brief     Holds back the writes of changed device records until "commit()" is called
+  @details   Every call changing a device setting such as "setMode()" stores the device record,
+             which on the ESP32 and ESP8266 means erasing and writing a flash sector each time.
+             When deferred, the changes are only kept in RAM and written in one go by "commit()".
+             Without the device cache (see the class constructor) the records on the EEPROM of the
+             AVR, Teensy and STM32F1 are still written straight away, as there is no other copy to
+             keep them in, but only the bytes which changed. Turning deferral off commits any
+             pending changes
+  @param[in] deferred Set to hold back writes, clear to write each change straight away
+  */
+  _commitOnWrite = !deferred;
+  if (!deferred) commit();
+}  // of method setDeferredCommit()
+void INA_Class::commit() {
+  /*!
+  @brief     Writes the device records changed since the last commit to EEPROM or flash
+  @details   Only records which differ from those stored are written, and the flash of the ESP32
+             and ESP8266 is only committed when something has been written. See
+             "setDeferredCommit()"
+  */
+  if (_DeviceState != nullptr && _DeviceCache != nullptr) {
+    for (uint8_t i = 0; i < _DeviceCount; i++) {
+      if (!_DeviceState[i].recordDirty) continue;  // Record hasn't changed
+      _DeviceState[i].recordDirty = false;
+      inaEE                       = _DeviceCache[i];  // only the stored part of the cache
+      storeRecord(i);
+    }  // of for-next each device
+  }    // of if-then changes may be held in the cache
+  bool deferred  = _commitOnWrite;
+  _commitOnWrite = true;  // Commit even when writes are deferred
+  commitEEPROM();
+  _commitOnWrite = deferred;
+}  // of method commit()
+void INA_Class::setI2CSpeed(const uint32_t i2cSpeed, const uint8_t i2cDelay, const uint8_t bus) {
   /*! @brief     Set a new I2C speed
       @details   I2C allows various bus speeds, see the enumerated type I2C_MODES for the standard
                  speeds. The valid speeds are  100KHz, 400KHz, 1MHz and 3.4MHz. Default to 100KHz
-                 when not specified. No range checking is done.
-      @param[in] i2cSpeed [optional] changes the I2C speed to the rate specified in Herz */
-  Wire.setClock(i2cSpeed);
+                 when not specified. No range checking is done. The delay the library waits after
+                 each register pointer write and register write is set at the same time, by default
+                 it is I2C_DELAY at 100KHz and scaled down in proportion to the bus speed. Each bus
+                 keeps its own delay, so a slow bus keeps its delay when a faster one is set
+      @param[in] i2cSpeed [optional] changes the I2C speed to the rate specified in Herz
+      @param[in] i2cDelay [optional] delay in microseconds, 0 for none. When not specified the
+                 delay is computed from the bus speed
+      @param[in] bus [optional] bus number returned by addBus() to set, all buses when omitted */
+  uint8_t delay = i2cDelay;  // Use the delay specified
+  if (i2cDelay == UINT8_MAX) {
+    uint32_t scaled = (uint32_t)I2C_DELAY * INA_I2C_STANDARD_MODE / (i2cSpeed ? i2cSpeed : 1);
+    delay           = scaled > UINT8_MAX - 1 ? UINT8_MAX - 1 : scaled;  // Clamp slow speeds
+  }  // if-then no delay was specified
+  for (uint8_t i = 0; i < INA_MAX_BUSES; i++) {
+    if (bus != UINT8_MAX && bus != i) continue;  // Set all or just one bus
+    if (i < _BusCount) _Bus[i]->setClock(i2cSpeed);
+    _i2cDelay[i] = delay;  // Kept for buses added later
+  }  // of for-next each bus
 }  // of method setI2CSpeed
+uint8_t INA_Class::busDelay() const {
+  /*! @brief     Return the I2C delay of the bus of the currently loaded device, see setI2CSpeed()
+      @return    Microseconds to wait after pointer and register writes */
+  return (_i2cDelay[ina.bus < _BusCount ? ina.bus : 0]);
+}  // of method busDelay()
 uint8_t INA_Class::begin(const uint16_t maxBusAmps, const uint32_t microOhmR,
                          const uint8_t deviceNumber) {
   /*! @brief     Initializes the contents of the class
@@ -233,6 +934,7 @@ uint8_t INA_Class::begin(const uint16_t maxBusAmps, const uint32_t microOhmR,
   uint16_t originalRegister, tempRegister;
   if (_DeviceCount == 0)  // Enumerate all devices on first call
   {
+    _deferCommit        = true;  // Only commit the EEPROM once all devices are stored
     uint16_t maxDevices = 32;
 /***************************************************************************************************
 ** The AVR devices need to use EEPROM to save memory, some other devices have emulation for EEPROM**
@@ -242,101 +944,347 @@ uint8_t INA_Class::begin(const uint16_t maxBusAmps, const uint32_t microOhmR,
 ** runtime to allocate sufficient space for 32 devices.                                           **
 ***************************************************************************************************/
 #if defined(ESP32) || defined(ESP8266)
-    EEPROM.begin(_EEPROM_size + _EEPROM_offset);  // If ESP32 then allocate 512 Bytes
+    EEPROM.begin(_EEPROM_size + _EEPROM_offset + sizeof(inaHeader));  // Allocate 512 Bytes
     maxDevices = (_EEPROM_size) / sizeof(inaEE);  // and compute number of devices
 #elif defined(__STM32F1__)                        // Emulated EEPROM for STM32F1
-    maxDevices                     = (EEPROM.maxcount() - _EEPROM_offset) / sizeof(inaEE);  // Compute max possible
+    maxDevices = (EEPROM.maxcount() - _EEPROM_offset) / ((sizeof(inaEE) + 1) / 2);  // In words
 #elif defined(CORE_TEENSY)                        // TEENSY doesn't have EEPROM.length
-    maxDevices = (2048 - _EEPROM_offset) / sizeof(inaEE);  // defined, so use 2Kb as value
+    maxDevices = (2048 - _EEPROM_offset - sizeof(inaHeader)) / sizeof(inaEE);  // so use 2Kb
 #elif defined(__AVR__)
-    maxDevices = (EEPROM.length() - _EEPROM_offset) / sizeof(inaEE);  // Compute max possible
+    maxDevices = (EEPROM.length() - _EEPROM_offset - sizeof(inaHeader)) / sizeof(inaEE);
 #else
-    maxDevices = 32;
+    maxDevices = 255;  // Storage grows as devices are found
 #endif
-    Wire.begin();
+    _Bus[0]->begin();  // Other buses have been started by the caller before addBus()
 
     if (maxDevices > 255)  // Limit number of devices to an 8-bit number
     {
       maxDevices = 255;
-    }  // of if-then more than 255 devices possible
-    for (uint8_t deviceAddress = 0x40; deviceAddress <= 0x4F;
-         deviceAddress++)  // Loop for each I2C addr
+    }                                             // of if-then more than 255 devices possible
+    if (_expectedDevices) maxDevices = _expectedDevices;  // Can't store more than allocated
+    for (uint8_t bus = 0; bus < _BusCount; bus++)  // Search each I2C bus in turn
     {
-      Wire.beginTransmission(deviceAddress);
-      uint8_t good = Wire.endTransmission();
-      if (good == 0 && _DeviceCount < maxDevices)  // If no error and EEPROM has space
+      uint16_t direct      = 0;  // Addresses answering with all mux channels switched off
+      uint8_t  muxChannels = _MuxAddress[bus] ? INA_MUX_CHANNELS : 0;
+      for (uint8_t mux = 0; mux <= muxChannels; mux++)  // Search bus, then each mux channel
       {
-        originalRegister = readWord(INA_CONFIGURATION_REGISTER, deviceAddress);  // Save settings
-        writeWord(INA_CONFIGURATION_REGISTER, INA_RESET_DEVICE, deviceAddress);  // Force reset
-        tempRegister = readWord(INA_CONFIGURATION_REGISTER, deviceAddress);      // Read reset reg.
-        if (tempRegister == INA_RESET_DEVICE)  // If the register wasn't reset then not an INA
+        ina.bus        = bus;  // Direct the I2C calls below to this bus
+        ina.muxChannel = mux;  // and to this mux channel, 0 is none
+        for (uint8_t deviceAddress = 0x40; deviceAddress <= 0x4F;
+             deviceAddress++)  // Loop for each I2C addr
         {
-          writeWord(INA_CONFIGURATION_REGISTER, originalRegister, deviceAddress);  // restore value
-        } else {
-          if (tempRegister == 0x399F) {
-            inaEE.type = INA219;
-          } else {
-            if (tempRegister == 0x4127)  // INA226, INA230, INA231
+          if (mux && bitRead(direct, deviceAddress - 0x40)) continue;  // Not behind the mux
+          wire().beginTransmission(deviceAddress);
+          uint8_t good = wire().endTransmission();
+          INA_COUNT(i2cTransactions, 1);
+          if (good == 0 && mux == 0) bitSet(direct, deviceAddress - 0x40);  // Remember address
+          if (good == 0)  // If no error then check the device
+          {
+            _readError       = false;
+            originalRegister = readWord(INA_CONFIGURATION_REGISTER, deviceAddress);  // Save
+            if (readFailed()) continue;  // Registers can't be read, so not an INA device
+            writeWord(INA_CONFIGURATION_REGISTER, INA_RESET_DEVICE, deviceAddress);  // Force reset
+            tempRegister = readWord(INA_CONFIGURATION_REGISTER, deviceAddress);      // Read reset
+            if (readFailed()) continue;            // Stopped answering, so not an INA device
+            if (tempRegister == INA_RESET_DEVICE)  // If the register wasn't reset then not an INA
             {
-              tempRegister = readWord(INA_DIE_ID_REGISTER, deviceAddress);  // Read the INA high-reg
-              if (tempRegister == INA226_DIE_ID_VALUE) {
-                inaEE.type = INA226;
-              } else {
-                if (tempRegister != 0) {
-                  inaEE.type = INA230;
-                } else {
-                  inaEE.type = INA231;
-                }  // of if-then-else a INA230 or INA231
-              }    // of if-then-else an INA226
+              writeWord(INA_CONFIGURATION_REGISTER, originalRegister, deviceAddress);  // restore
             } else {
-              if (tempRegister == 0x6127) {
-                inaEE.type = INA260;
+              if (tempRegister == 0x399F) {
+                inaEE.type = INA219;
               } else {
-                if (tempRegister == 0x7127) {
-                  inaEE.type = INA3221_0;
+                if (tempRegister == 0x4127)  // INA226, INA230, INA231
+                {
+                  tempRegister = readWord(INA_DIE_ID_REGISTER, deviceAddress);  // Read INA high-reg
+                  if (tempRegister == INA226_DIE_ID_VALUE) {
+                    inaEE.type = INA226;
+                  } else {
+                    if (tempRegister != 0) {
+                      inaEE.type = INA230;
+                    } else {
+                      inaEE.type = INA231;
+                    }  // of if-then-else a INA230 or INA231
+                  }    // of if-then-else an INA226
                 } else {
-                  if (tempRegister == 0x0) {
-                    inaEE.type = INA228;
+                  if (tempRegister == 0x6127) {
+                    inaEE.type = INA260;
                   } else {
-                    inaEE.type = INA_UNKNOWN;
-                  }                       // of if-then-else it is an INA228
-                }                         // of if-then-else it is an INA3221
-              }                           // of if-then-else it is an INA260
-            }                             // of if-then-else it is an INA226, INA230, INA231
-          }                               // of if-then-else it is an INA209, INA219, INA220
-          if (inaEE.type != INA_UNKNOWN)  // Increment device if valid INA2xx
-          {
-            inaEE.address    = deviceAddress;
-            inaEE.maxBusAmps = maxBusAmps > 1022 ? 1022 : maxBusAmps;  // Clamp to maximum of 1022A
-            inaEE.microOhmR  = microOhmR;
-            ina              = inaEE;  // see inaDet constructor
-            if (inaEE.type == INA3221_0) {
-              ina.type = INA3221_0;  // Set to INA3221 1st channel
-              initDevice(_DeviceCount);
-              _DeviceCount = ((_DeviceCount + 1) % maxDevices);
-              ina.type     = INA3221_1;  // Set to INA3221 2nd channel
-              initDevice(_DeviceCount);
-              _DeviceCount = ((_DeviceCount + 1) % maxDevices);
-              ina.type     = INA3221_2;  // Set to INA3221 3rd channel
-              initDevice(_DeviceCount);
-              _DeviceCount = ((_DeviceCount + 1) % maxDevices);
-            } else {
-              initDevice(_DeviceCount);                          // perform initialization on device
-              _DeviceCount = ((_DeviceCount + 1) % maxDevices);  // start again at 0 if overflow
-            }                                                    // of if-then inaEE.type
-          }                                                      // of if-then we can add device
-        }  // of if-then-else we have an INA-Type device
-      }    // of if-then we have a device
-    }      // for-next each possible I2C address
+                    if (tempRegister == 0x7127) {
+                      inaEE.type = INA3221_0;
+                    } else {
+                      if (tempRegister == 0x0) {
+                        inaEE.type = INA228;
+                      } else {
+                        inaEE.type = INA_UNKNOWN;
+                      }                       // of if-then-else it is an INA228
+                    }                         // of if-then-else it is an INA3221
+                  }                           // of if-then-else it is an INA260
+                }                             // of if-then-else it is an INA226, INA230, INA231
+              }                               // of if-then-else it is an INA209, INA219, INA220
+              uint8_t channels = (inaEE.type == INA3221_0) ? 3 : 1;  // INA3221 has 3 channels
+              if (inaEE.type != INA_UNKNOWN && _DeviceCount + channels <= maxDevices)
+              {  // Store device if valid INA2xx and there is space, configured below
+                inaEE.address    = deviceAddress;
+                inaEE.maxBusAmps = maxBusAmps > 1022 ? 1022 : maxBusAmps;  // Clamp to max. 1022A
+                inaEE.microOhmR  = microOhmR;
+                inaEE.bus        = bus;
+                inaEE.muxChannel = mux;
+                uint8_t type     = inaEE.type;  // writeInatoEEPROM() overwrites inaEE below
+                for (uint8_t ch = 0; ch < channels; ch++) {
+                  ina      = inaEE;      // see inaDet constructor
+                  ina.type = type + ch;  // INA3221 channel types are consecutive
+                  writeInatoEEPROM(_DeviceCount);
+                  _DeviceCount++;
+                }  // of for-next each channel
+              }    // of if-then we can add device
+            }  // of if-then-else we have an INA-Type device
+          }    // of if-then we have a device
+        }        // for-next each possible I2C address
+      }          // of for-next each mux channel
+    }  // of for-next each I2C bus
+    for (uint8_t i = 0; i < _DeviceCount; i++)  // Configure all devices once the scan is done
+    {
+      _currentINA = UINT8_MAX;  // Force a read from storage
+      readInafromEEPROM(i);     // Load EEPROM to ina structure
+      initDevice(i);            // and write the calibration to the device
+    }                           // of for-next each device found
+    writeHeader();              // Mark the records as valid for resume()
+    _deferCommit = false;
+    commitEEPROM();  // Write all records to the persistent store in one go
+    fitStorage();    // Give back the unused records before the runtime state is allocated
+    setupDevices();
   } else {
-    readInafromEEPROM(deviceNumber);                         // Load EEPROM to ina structure
-    ina.maxBusAmps = maxBusAmps > 1022 ? 1022 : maxBusAmps;  // Clamp to maximum of 1022A
-    ina.microOhmR  = microOhmR;
-    initDevice(deviceNumber);
+    readInafromEEPROM(deviceNumber);                           // Load EEPROM to ina structure
+    inaEE            = ina;                                    // Stored part of the record
+    inaEE.maxBusAmps = maxBusAmps > 1022 ? 1022 : maxBusAmps;  // Clamp to maximum of 1022A
+    inaEE.microOhmR  = microOhmR;
+    ina              = inaEE;  // Recompute current_LSB and adcRange, see inaDet constructor
+    bool ranged = _Ranges != nullptr && _Ranges[deviceNumber].enabled;
+    if (ranged) {  // Start auto-ranging again from the new range, keeping the shunt limits
+      _Ranges[deviceNumber].peak  = 0;
+      _Ranges[deviceNumber].count = 0;
+      _Ranges[deviceNumber].fine  = ina.adcRange;
+    }                             // of if-then auto-ranged INA228
+    initDevice(deviceNumber);     // Store the record and write the calibration
+    if (ranged) applyRange(deviceNumber, ina.adcRange);  // Shunt limits in the new range
+    if (_DeviceState != nullptr) computeScales(deviceNumber);  // Factors depend on calibration
   }                         // of if-then-else first call
   _currentINA = UINT8_MAX;  // Force read on next call
   return _DeviceCount;
 }  // of method begin()
+uint8_t INA_Class::addBus(TwoWire &bus) {
+  /*! @brief     Add another I2C bus to be searched for devices
+      @details   The default "Wire" bus is always bus 0. Any further buses, such as "Wire1", have to
+                 be started by the program and added before "begin()" or "resume()" is called. The
+                 devices found are numbered by bus, those on bus 0 first. Reads done by "readAll()"
+                 and "poll()" alternate between the buses
+      @param[in] bus TwoWire instance of the bus
+      @return    Bus number of the added bus, UINT8_MAX when no more buses can be added */
+  if (_DeviceCount) return (UINT8_MAX);  // Too late, devices have already been found
+  for (uint8_t i = 0; i < _BusCount; i++) {
+    if (_Bus[i] == &_WireBus[i] && _WireBus[i].bus() == &bus) return (i);  // Already known
+  }  // of for-next each bus
+  if (_BusCount >= INA_MAX_BUSES) return (UINT8_MAX);
+  _WireBus[_BusCount] = INA_WireTransport(&bus);
+  return (addBus(_WireBus[_BusCount]));
+}  // of method addBus()
+uint8_t INA_Class::addBus(INA_Transport &transport) {
+  /*! @brief     Add another bus, reached through any transport, to be searched for devices
+      @details   As "addBus(TwoWire&)", but the bus is any implementation of "INA_Transport", for
+                 instance the "INA_Simulator" register model. The transport has to stay in scope
+                 for as long as the library is used
+      @param[in] transport Transport of the bus
+      @return    Bus number of the added bus, UINT8_MAX when no more buses can be added */
+  if (_DeviceCount) return (UINT8_MAX);  // Too late, devices have already been found
+  for (uint8_t i = 0; i < _BusCount; i++) {
+    if (_Bus[i] == &transport) return (i);  // Already known
+  }                                         // of for-next each bus
+  if (_BusCount >= INA_MAX_BUSES) return (UINT8_MAX);
+  _Bus[_BusCount] = &transport;
+  return (_BusCount++);
+}  // of method addBus()
+bool INA_Class::setTransport(INA_Transport &transport, const uint8_t bus) {
+  /*! @brief     Replace the transport of a bus, such as the default "Wire" of bus 0
+      @details   Used to run the library on top of another I2C implementation or a simulation
+                 without any changes to the program. This has to be done before "begin()" or
+                 "resume()" is called, the transport has to stay in scope for as long as the
+                 library is used
+      @param[in] transport Transport to use for the bus
+      @param[in] bus [optional] Bus number, see "addBus()"
+      @return    "true" on success, "false" for an unknown bus or after begin() */
+  if (_DeviceCount || bus >= _BusCount) return (false);
+  _Bus[bus] = &transport;
+  return (true);
+}  // of method setTransport()
+bool INA_Class::addMux(const uint8_t muxAddress, const uint8_t bus) {
+  /*! @brief     Declare a TCA9548A (or compatible) I2C multiplexer on a bus
+      @details   Only 16 I2C addresses are available to the INA devices, a multiplexer allows up to
+                 16 devices on each of its 8 channels. "begin()" then searches the bus itself and
+                 each of the channels, devices answering on the bus itself are not searched for
+                 again behind the multiplexer. The channel is only switched when a device on a
+                 different channel is accessed. One multiplexer per bus is supported and it has to
+                 be declared before "begin()" or "resume()" is called
+      @param[in] muxAddress I2C address of the multiplexer, 0x70 to 0x77
+      @param[in] bus [optional] Bus number the multiplexer is on, see "addBus()"
+      @return    "true" on success, "false" for an unknown bus or after begin() */
+  if (_DeviceCount || bus >= _BusCount) return (false);
+  _MuxAddress[bus] = muxAddress;
+  _MuxChannel[bus] = UINT8_MAX;  // Unknown, force a write on first use
+  return (true);
+}  // of method addMux()
+uint8_t INA_Class::resume() {
+  /*! @brief     Fast start which trusts the device records stored by a previous begin()
+      @details   After a warm reboot the INA devices still hold the configuration written before, so
+                 the I2C scan, identification and calibration done in begin() can be skipped. The
+                 stored records are only used if they carry a valid header and every device still
+                 answers at its stored address and holds the calibration computed from its record.
+                 A device which was power cycled has lost its calibration, so a cold boot returns 0
+                 as well, and begin() needs to be called. This costs one register read per device
+                 and can't detect a power cycled INA260 or INA3221, which have no calibration
+                 register. Only available when the device records are stored in EEPROM
+      @return    The number of devices restored, 0 if begin() needs to be called */
+  if (_DeviceCount) return (_DeviceCount);  // Already initialized
+#if (defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266)) && \
+    !defined(__STM32F1__)
+  if (_expectedDevices) return (0);  // Records in RAM don't survive a reboot
+  #if defined(ESP32) || defined(ESP8266)
+  EEPROM.begin(_EEPROM_size + _EEPROM_offset + sizeof(inaHeader));  // Allocate EEPROM space
+  #endif
+  inaHeader header;
+  EEPROM.get(_EEPROM_offset, header);  // Read header ahead of the device records
+  if (header.signature != INA_EEPROM_SIGNATURE || header.recordSize != sizeof(inaEEPROM) ||
+      header.deviceCount == 0) {
+    return (0);
+  }  // of if-then no valid records stored
+  _Bus[0]->begin();  // Other buses have been started by the caller before addBus()
+  _DeviceCount = header.deviceCount;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Check each device still answers
+  {
+    readInafromEEPROM(i);  // Load EEPROM to ina structure
+    bool known = ina.bus < _BusCount && (ina.muxChannel == 0 || _MuxAddress[ina.bus]);
+    if (known) wire().beginTransmission(ina.address);
+    if (!known || wire().endTransmission() != 0 || !calibrated()) {
+      _DeviceCount = 0;  // Device missing or reset, a full begin() is required
+      _currentINA  = UINT8_MAX;
+      return (0);
+    }  // of if-then device doesn't answer or lost its settings
+  }    // of for-next each device
+  setupDevices();
+#endif
+  _currentINA = UINT8_MAX;  // Force read on next call
+  return (_DeviceCount);
+}  // of method resume()
+void INA_Class::fitStorage() {
+  /*! @brief     Shrinks the device records kept in RAM to exactly the number of devices found
+      @details   Called once the devices have been enumerated and before the runtime arrays are
+                 allocated, so that these can reuse the memory given back. Devices are only ever
+                 enumerated once, so the records never need to grow again */
+  if (_DeviceCount == 0) return;  // Nothing found, keep the storage for the next attempt
+  if (_expectedDevices > _DeviceCount) {
+    inaEEPROM *fitted = new inaEEPROM[_DeviceCount];
+    for (uint8_t i = 0; i < _DeviceCount; i++) fitted[i] = _DeviceArray[i];
+    delete[] _DeviceArray;
+    _DeviceArray = fitted;
+  }  // of if-then records in RAM
+#if defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266) || (__STM32F1__)
+#else
+  if (_EmulationSize > _DeviceCount) {
+    inaEEPROM *fitted = new inaEEPROM[_DeviceCount];
+    for (uint8_t i = 0; i < _DeviceCount; i++) fitted[i] = _EEPROMEmulation[i];
+    delete[] _EEPROMEmulation;
+    _EEPROMEmulation = fitted;
+    _EmulationSize   = _DeviceCount;
+  }  // of if-then emulated EEPROM larger than needed
+#endif
+}  // of method fitStorage()
+bool INA_Class::setupState() {
+  /*! @brief     Allocates the runtime state of all devices the first time it is needed
+      @details   The shadow registers, conversion factors, timing and poll order are only used by
+                 "readAll()", the acquisition engine and the functions built on them, so a program
+                 which only uses the single device getters and setters doesn't pay the RAM for them.
+                 The state array is allocated, the shadow registers are loaded, the conversion
+                 factors precomputed and the buses interleaved in the poll order. Later calls return
+                 straight away. Loading the shadow registers clears the conversion-ready flags and
+                 latched alerts of the devices, see "syncRegisters()", so the first "readAll()" or
+                 other call which sets up the state does that as well
+      @return    "false" if there are no devices, otherwise "true" */
+  if (_DeviceState != nullptr) return (true);  // Already set up
+  if (_DeviceCount == 0) return (false);       // Nothing to set up
+  _DeviceState = new inaState[_DeviceCount]();  // One zeroed runtime state entry per device
+  for (uint8_t i = 0; i < _DeviceCount; i++) {
+    _DeviceState[i].chip        = i;  // Each device is its own physical device
+    _DeviceState[i].timingScale = INA_TIMING_DEFAULT;
+    readInafromEEPROM(i);  // except for the 2nd and 3rd INA3221 channels
+    if (ina.type == INA3221_1 || ina.type == INA3221_2) {
+      _DeviceState[i].chip = i - (ina.type - INA3221_0);
+    }  // of if-then a secondary INA3221 channel
+  }    // of for-next each device found
+  syncRegisters();  // Load the shadow registers from the devices
+  _PollOrder    = new uint8_t[_DeviceCount];  // Interleave the buses, 1st device of each bus,
+  uint8_t count = 0;                          // then the 2nd device of each bus and so on
+  for (uint8_t rank = 0; count < _DeviceCount; rank++) {
+    for (uint8_t bus = 0; bus < _BusCount; bus++) {
+      uint8_t seen = 0;  // Devices on this bus so far
+      for (uint8_t i = 0; i < _DeviceCount; i++) {
+        readInafromEEPROM(i);
+        if (ina.bus == bus && seen++ == rank) {
+          _PollOrder[count++] = i;
+          break;
+        }  // of if-then the device of this rank on this bus
+      }    // of for-next each device
+    }      // of for-next each bus
+  }        // of for-next each rank
+  for (uint8_t i = 0; i < _DeviceCount; i++) {
+    readInafromEEPROM(i);  // Load EEPROM to ina structure
+    computeScales(i);      // and precompute the conversion factors
+  }                        // of for-next each device found
+  _currentINA = UINT8_MAX;  // Force read on next call
+  return (true);
+}  // of method setupState()
+void INA_Class::setupDevices() {
+  /*! @brief     Sets up the decoded device cache once the devices have been enumerated
+      @details   Only done if requested in the constructor. The cache is the fast mode of the
+                 library, so the runtime state of "setupState()" is allocated along with it */
+  if (_DeviceCount == 0 || !_cacheDevices) return;  // Nothing to set up
+  setupState();
+  inaDet *cache = new inaDet[_DeviceCount];  // Allocate exactly the number of devices found
+  for (uint8_t i = 0; i < _DeviceCount; i++) {
+    _currentINA = UINT8_MAX;  // Force a read from storage
+    readInafromEEPROM(i);     // Load and decode the stored values
+    cache[i] = ina;           // and keep the decoded copy
+  }                           // of for-next each device found
+  _DeviceCache = cache;       // From now on all reads come from RAM
+}  // of method setupDevices()
+void INA_Class::commitEEPROM() {
+  /*! @brief     Writes pending EEPROM changes to the persistent store on platforms which emulate
+                 EEPROM in flash, a no-op elsewhere
+      @details   Nothing is done if nothing has changed, while begin(), setMode() or reset() are
+                 batching the writes of several devices or while "setDeferredCommit()" is set */
+#if defined(ESP32) || defined(ESP8266)
+  if (!_commitPending || _deferCommit || !_commitOnWrite) return;  // Nothing to do yet
+  _commitPending = false;
+  if (_expectedDevices == 0) EEPROM.commit();  // Flash write, slow so batched where possible
+#endif
+}  // of method commitEEPROM()
+void INA_Class::writeHeader() {
+  /*! @brief     Writes the header marking the stored device records as valid, see resume() */
+#if (defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266)) && \
+    !defined(__STM32F1__)
+  if (_expectedDevices) return;  // Records are in RAM, no header needed
+  inaHeader header;
+  header.signature   = INA_EEPROM_SIGNATURE;
+  header.recordSize  = sizeof(inaEEPROM);
+  header.deviceCount = _DeviceCount;
+  inaHeader stored;
+  EEPROM.get(_EEPROM_offset, stored);
+  if (stored.signature == header.signature && stored.recordSize == header.recordSize &&
+      stored.deviceCount == header.deviceCount) {
+    return;
+  }  // of if-then header unchanged
+  EEPROM.put(_EEPROM_offset, header);
+  _commitPending = true;
+#endif
+}  // of method writeHeader()
 void INA_Class::initDevice(const uint8_t deviceNumber) {
   /*! @brief     Initializes the the given devices using the settings from the internal structure
       @details   This includes (re)computing the device's calibration values.
@@ -347,9 +1295,7 @@ void INA_Class::initDevice(const uint8_t deviceNumber) {
   uint16_t calibration, maxShuntmV, tempRegister;  // Calibration temporary variables
   switch (ina.type) {
     case INA219:  // Set up INA219 or INA220
-      // Compute calibration register
-      calibration = (uint64_t)409600000 /
-                    ((uint64_t)ina.current_LSB * (uint64_t)ina.microOhmR / (uint64_t)100000);
+      calibration = calibrationValue();                               // Compute calibration
       writeWord(INA_CALIBRATION_REGISTER, calibration, ina.address);  // Write calibration
       /* Determine optimal programmable gain with maximum accuracy so no chance of an overflow */
       maxShuntmV = ina.maxBusAmps * ina.microOhmR / 1000;  // Compute maximum shunt mV
@@ -364,22 +1310,64 @@ void INA_Class::initDevice(const uint8_t deviceNumber) {
       tempRegister = 0x399F & INA219_CONFIG_PG_MASK;            // Zero programmable gain
       tempRegister |= programmableGain << INA219_PG_FIRST_BIT;  // Overwrite the new values
       bitSet(tempRegister, INA219_BRNG_BIT);                    // set to 1 for 0-32 volts
-      writeWord(INA_CONFIGURATION_REGISTER, tempRegister, ina.address);  // Write to config register
+      setConfiguration(tempRegister);                           // Write to config register
       break;
     case INA226:
     case INA230:
     case INA231:
-      // Compute calibration register
-      calibration = (uint64_t)51200000 /
-                    ((uint64_t)ina.current_LSB * (uint64_t)ina.microOhmR / (uint64_t)100000);
+      calibration = calibrationValue();                               // Compute calibration
       writeWord(INA_CALIBRATION_REGISTER, calibration, ina.address);  // Write calibration
       break;
+    case INA228:
+      writeWord(INA228_SHUNT_CAL_REGISTER, ina228Calibration(), ina.address);  // Write calibration
+      tempRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);
+      bitWrite(tempRegister, INA228_ADCRANGE_BIT, ina.adcRange);  // Select the shunt range
+      writeWord(INA_CONFIGURATION_REGISTER, tempRegister, ina.address);
+      if (_Ranges != nullptr) _Ranges[deviceNumber].config = tempRegister;  // See applyRange()
+      break;
     case INA260:
     case INA3221_0:
     case INA3221_1:
     case INA3221_2: break;
   }  // of switch type
 }  // of method initDevice()
+uint16_t INA_Class::calibrationValue() const {
+  /*! @brief     Compute the calibration register of the currently loaded INA219, INA226, INA230 or
+                 INA231 from its stored record
+      @return    Calibration register contents, 0 for other device types */
+  uint64_t divisor = (uint64_t)ina.current_LSB * (uint64_t)ina.microOhmR / (uint64_t)100000;
+  switch (ina.type) {
+    case INA219: return ((uint64_t)409600000 / divisor);
+    case INA226:
+    case INA230:
+    case INA231: return ((uint64_t)51200000 / divisor);
+    default: return (0);
+  }  // of switch type
+}  // of method calibrationValue()
+bool INA_Class::calibrated() {
+  /*! @brief     Check that the currently loaded device still holds the calibration of its record
+      @details   A device which has lost power comes back with its reset calibration (0, or 4096
+                 for the INA228 SHUNT_CAL) and its default configuration. An auto-ranged INA228 may
+                 have been left in either shunt range, so both values are accepted. The INA260 and
+                 INA3221 have no calibration register, so this can't be checked on them
+      @return    "true" if the calibration matches or can't be checked */
+  switch (ina.type) {
+    case INA219:
+    case INA226:
+    case INA230:
+    case INA231:
+      return ((uint16_t)readWord(INA_CALIBRATION_REGISTER, ina.address) == calibrationValue());
+    case INA228: {
+      uint16_t calibration = readWord(INA228_SHUNT_CAL_REGISTER, ina.address) & 0x7FFF;
+      bool     matches     = calibration == ina228Calibration();
+      ina.adcRange         = !ina.adcRange;  // Try the other shunt range
+      matches              = matches || calibration == ina228Calibration();
+      ina.adcRange         = !ina.adcRange;
+      return (matches);
+    }
+    default: return (true);
+  }  // of switch type
+}  // of method calibrated()
 void INA_Class::setBusConversion(const uint32_t convTime, const uint8_t deviceNumber) {
   /*! @brief     specifies the conversion rate in microseconds, rounded to the nearest valid value
       @details   INA devices can have a conversion rate of up to 68100 microseconds
@@ -395,7 +1383,7 @@ void INA_Class::setBusConversion(const uint32_t convTime, const uint8_t deviceNu
     if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i)  // If device needs setting
     {
       readInafromEEPROM(i);  // Load EEPROM values to ina structure
-      configRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);  // Get current register
+      configRegister = getConfiguration();  // Get current register
       switch (ina.type) {
         case INA219:
           if (convTime >= 68100)
@@ -423,6 +1411,11 @@ void INA_Class::setBusConversion(const uint32_t convTime, const uint8_t deviceNu
           configRegister &= ~INA219_CONFIG_BADC_MASK;  // zero out the averages part
           configRegister |= convRate << 7;             // shift in the BADC averages
           break;
+        case INA228:
+          convRate = ina228ConversionCode(convTime);
+          configRegister &= ~INA228_ADC_BUS_MASK;  // zero out the VBUSCT part
+          configRegister |= convRate << 9;         // shift in the VBUSCT bits
+          break;
         case INA226:
         case INA230:
         case INA231:
@@ -456,11 +1449,24 @@ void INA_Class::setBusConversion(const uint32_t convTime, const uint8_t deviceNu
           }                                              // of if-then an INA226 or INA260
           break;
       }  // of switch type
-      writeWord(INA_CONFIGURATION_REGISTER, configRegister,
-                ina.address);  // Save new value to device
-    }                          // of if this device needs to be set
+      setConfiguration(configRegister);  // Save new value to device
+    }                                    // of if this device needs to be set
   }                            // for-next each device loop
 }  // of method setBusConversion()
+uint8_t INA_Class::ina228ConversionCode(const uint32_t convTime) const {
+  /*! @brief     Returns the INA228 ADC_CONFIG conversion time code for a time in microseconds
+      @details   The same codes are used for the bus, shunt and temperature conversion times
+      @param[in] convTime Conversion time in microseconds, rounded down to the next valid value
+      @return    Conversion time code 0-7 */
+  if (convTime >= 4120) return (7);
+  if (convTime >= 2074) return (6);
+  if (convTime >= 1052) return (5);
+  if (convTime >= 540) return (4);
+  if (convTime >= 280) return (3);
+  if (convTime >= 150) return (2);
+  if (convTime >= 84) return (1);
+  return (0);
+}  // of method ina228ConversionCode()
 void INA_Class::setShuntConversion(const uint32_t convTime, const uint8_t deviceNumber) {
   /*! @brief     specifies the conversion rate in microseconds, rounded to the nearest valid value
       @details   INA devices can have a conversion rate of up to 68100 microseconds
@@ -476,7 +1482,7 @@ void INA_Class::setShuntConversion(const uint32_t convTime, const uint8_t device
         deviceNumber % _DeviceCount == i)  // If this device needs setting
     {
       readInafromEEPROM(i);  // Load EEPROM to ina structure
-      configRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);  // Get register contents
+      configRegister = getConfiguration();  // Get register contents
       switch (ina.type) {
         case INA219:
           if (convTime >= 68100)
@@ -504,6 +1510,11 @@ void INA_Class::setShuntConversion(const uint32_t convTime, const uint8_t device
           configRegister &= ~INA219_CONFIG_SADC_MASK;  // zero out the averages part
           configRegister |= convRate << 3;             // shift in the SADC averages
           break;
+        case INA228:
+          convRate = ina228ConversionCode(convTime);
+          configRegister &= ~INA228_ADC_SHUNT_MASK;  // zero out the VSHCT part
+          configRegister |= convRate << 6;           // shift in the VSHCT bits
+          break;
         case INA226:
         case INA230:
         case INA231:
@@ -536,9 +1547,8 @@ void INA_Class::setShuntConversion(const uint32_t convTime, const uint8_t device
           configRegister |= convRate << 3;  // shift in the averages to register
           break;
       }  // of switch type
-      writeWord(INA_CONFIGURATION_REGISTER, configRegister,
-                ina.address);  // Save new value to device
-    }                          // of if this device needs to be set
+      setConfiguration(configRegister);  // Save new value to device
+    }                                    // of if this device needs to be set
   }                            // for-next each device loop
 }  // of method setShuntConversion()
 const char *INA_Class::getDeviceName(const uint8_t deviceNumber) {
@@ -571,6 +1581,148 @@ uint8_t INA_Class::getDeviceAddress(const uint8_t deviceNumber) {
   readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
   return (ina.address);
 }  // of method getDeviceAddress()
+uint8_t INA_Class::getDeviceBus(const uint8_t deviceNumber) {
+  /*! @brief     returns the I2C bus number of the device specified in the input parameter
+      @details   Bus 0 is the default "Wire" bus, the others are numbered in the order they were
+                 added with "addBus()"
+      @param[in] deviceNumber to return the bus number of
+      @return    Bus number of the device. Returns UINT8_MAX if value is out-of-range
+      */
+  if (deviceNumber >= _DeviceCount) return UINT8_MAX;
+  readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
+  return (ina.bus);
+}  // of method getDeviceBus()
+bool INA_Class::getDeviceInfo(const uint8_t deviceNumber, inaDeviceInfo &info) {
+  /*! @brief     returns the calibration of the device specified in the input parameter
+      @details   The structure holds everything needed to convert the raw samples of the device
+                 away from the library, such as on a host reading a log written by the
+                 "INA_SampleEncoder" class
+      @param[in] deviceNumber to return the calibration of
+      @param[out] info Structure to fill
+      @return    "false" if the device number is out-of-range or begin() hasn't been called
+      */
+  if (deviceNumber >= _DeviceCount || !setupState()) return false;
+  readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
+  const inaState &state = _DeviceState[deviceNumber];
+  info.type             = ina.type;
+  info.address          = ina.address;
+  info.busVoltage_LSB   = ina.busVoltage_LSB();
+  info.shuntVoltage_LSB = ina.shuntVoltage_LSB();
+  info.current_LSB      = ina.current_LSB;
+  info.power_LSB        = ina.power_LSB();
+  info.microOhmR        = ina.microOhmR;
+  info.busScale         = state.busScale;
+  info.shuntScale       = state.shuntScale;
+  info.currentScale     = state.currentScale;
+  return true;
+}  // of method getDeviceInfo()
+void INA_Class::getCounters(inaCounters &counters) const {
+  /*!
+  @brief     Returns the library's I2C and EEPROM traffic counters
+  @details   The counters are only kept when the library is compiled with INA_COUNTERS set to 1,
+             otherwise all counters are returned as 0. They are meant for measuring what each
+             library call costs, see the "Benchmark" example
+  @param[out] counters Structure filled with the counters since the last "resetCounters()"
+  */
+#if INA_COUNTERS
+  counters = _Counters;
+#else
+  counters = inaCounters();
+#endif
+}  // of method getCounters()
+void INA_Class::resetCounters() {
+  /*!
+  @brief     Sets all of the traffic counters back to 0, see "getCounters()"
+  */
+#if INA_COUNTERS
+  _Counters = inaCounters();
+#endif
+}  // of method resetCounters()
+void INA_Class::setStatistics(const bool enabled) {
+  /*!
+  @brief     Switches the per-device acquisition and I2C health statistics on or off
+  @details   While switched on, every sample stored by the acquisition engine and every I2C transfer
+             to a device is counted, the transfers are timed with micros() and any which weren't
+             acknowledged or returned too few bytes are counted as failed. The statistics start
+             from 0 and are read with "getStatistics()". Switching them off frees their memory, so
+             the counting only costs time and RAM while it is wanted. Call this after "begin()"
+  @param[in] enabled Set to true to keep statistics, false to stop and free them
+  */
+  if (!enabled || _DeviceCount == 0) {
+    delete[] _Statistics;
+    _Statistics = nullptr;
+    return;
+  }  // of if-then switch off
+  if (_Statistics == nullptr) _Statistics = new inaStatistics[_DeviceCount]();  // Zeroed
+}  // of method setStatistics()
+bool INA_Class::getStatistics(const uint8_t deviceNumber, inaStatistics &statistics) const {
+  /*!
+  @brief     Returns the acquisition and I2C health statistics of a device, see "setStatistics()"
+  @details   The counters are copied and the achieved sample rate and average transfer time are
+             computed, which costs two divisions but no I2C traffic. The sample rate is measured
+             from the first to the latest sample since the last reset, in thousandths of a sample
+             per second. Overruns are estimated from the time between two samples of a device in a
+             continuous mode, see "calibrateTiming()" for the conversion times used. A transfer is
+             a register write, a read, or a pointer write and read joined by a repeated start, its
+             time includes the I2C delay after a write, see "setI2CSpeed()". The bucket "n" of the
+             histogram counts the transfers which took less than 2^(n+5) microseconds and at least
+             half of that, with the first bucket holding everything below 32us and the last one
+             everything from 2048us. Samples whose registers couldn't be read, even after the
+             retries, are dropped by the engine and counted in "dropped". The I2C figures and
+             dropped samples of an INA3221 are kept with its first channel
+  @param[in] deviceNumber Device to return the statistics of
+  @param[out] statistics Structure to return the statistics in
+  @return    "true" if statistics are kept and the device exists
+  */
+  if (_Statistics == nullptr || deviceNumber >= _DeviceCount) return false;
+  statistics                  = _Statistics[deviceNumber];
+  uint32_t span               = statistics.lastTick - statistics.firstTick;
+  statistics.sampleMilliHertz = 0;
+  if (statistics.samples > 1 && span != 0) {
+    statistics.sampleMilliHertz = (uint64_t)(statistics.samples - 1) * 1000000000ULL / span;
+  }  // of if-then rate measurable
+  statistics.averageMicros = 0;
+  if (statistics.transfers) statistics.averageMicros = statistics.sumMicros / statistics.transfers;
+  return true;
+}  // of method getStatistics()
+void INA_Class::resetStatistics(const uint8_t deviceNumber) {
+  /*!
+  @brief     Sets the statistics of one or all devices back to 0, see "getStatistics()"
+  @param[in] deviceNumber [optional] Device to reset, all devices when not specified
+  */
+  if (_Statistics == nullptr) return;
+  for (uint8_t i = 0; i < _DeviceCount; i++) {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i) {
+      _Statistics[i] = inaStatistics();
+    }  // of if-then device needs resetting
+  }    // of for-next each device
+}  // of method resetStatistics()
+bool INA_Class::readFailed() {
+  /*!
+  @brief     Returns whether a register read failed since the last call and clears the flag
+  @details   A read which isn't acknowledged or returns fewer bytes than requested, even after the
+             retries set with "setI2CRetries()", returns 0 instead of the bus contents. The getters
+             such as "getBusMilliVolts()" and "readAll()" then return 0 for the affected values, so
+             calling this afterwards tells a failed read from an actual reading of 0. The
+             acquisition engine drops such samples instead, see "getStatistics()"
+  @return    "true" if a read failed
+  */
+  bool failed = _readError;
+  _readError  = false;
+  return (failed);
+}  // of method readFailed()
+void INA_Class::setI2CRetries(const uint8_t retries) {
+  /*!
+  @brief     Sets how many times an I2C transfer to a device is repeated when it fails
+  @details   A transfer fails when the device doesn't acknowledge or returns fewer bytes than
+             requested, which on a noisy or overloaded bus would otherwise pass bad data on. By
+             default nothing is repeated. The repeats are counted in the statistics, see
+             "getStatistics()". Devices which don't answer at all are still reported as missing by
+             "begin()", as its search for devices is never repeated
+  @param[in] retries Number of repeats of a failed transfer, 0 to switch off
+  */
+  _i2cRetries = retries;
+}  // of method setI2CRetries()
 uint16_t INA_Class::getBusMilliVolts(const uint8_t deviceNumber) {
   /*! @brief     returns the bus voltage in millivolts
       @details   The converted millivolt value is returned and if the device is in triggered mode
@@ -578,13 +1730,7 @@ uint16_t INA_Class::getBusMilliVolts(const uint8_t deviceNumber) {
       @param[in] deviceNumber to return the device bus millivolts for
       @return uint16_t unsigned integer for the bus millivoltage */
   uint32_t busVoltage = getBusRaw(deviceNumber);  // Get raw voltage from device
-  if (ina.type == INA228) {
-    // The accuracy is 20bits and 195.3125uv is the LSB
-    busVoltage = (uint64_t)busVoltage * 1953125 / 10000000;  // conversion to get mV
-  } else {
-    busVoltage = busVoltage * ina.busVoltage_LSB / 100;  // conversion to get mV
-  }                                                      // if-then-else an INA228
-  return (busVoltage);
+  return (busToMilliVolts(busVoltage));
 }  // of method getBusMilliVolts()
 uint32_t INA_Class::getBusRaw(const uint8_t deviceNumber) {
   /*! @brief     returns the raw unconverted bus voltage reading from the device
@@ -592,24 +1738,12 @@ uint32_t INA_Class::getBusRaw(const uint8_t deviceNumber) {
                  conversion is started
       @param[in] deviceNumber to return the raw device bus voltage reading
       @return    Raw bus measurement */
-  readInafromEEPROM(deviceNumber);  // Load EEPROM from EEPROM
-  uint32_t raw{0};                  // define the return variable
-  if (ina.type == INA228) {
-    raw = read3Bytes(ina.busVoltageRegister, ina.address);  // Get the raw value from register
-    raw = raw >> 4;
-  } else {
-    raw = readWord(ina.busVoltageRegister, ina.address);  // Get the raw value from register
-    if (ina.type == INA3221_0 || ina.type == INA3221_1 || ina.type == INA3221_2 ||
-        ina.type == INA219) {
-      raw = raw >> 3;  // INA219 & INA3221 - the 3 LSB unused, so shift right
-    }                  // of if-then an INA219 or INA3221
-  }                    // if-then a 3byte bus voltage buffer
+  readInafromEEPROM(deviceNumber);    // Load EEPROM from EEPROM
+  uint32_t raw = readBusRegister();  // Get the raw value from register
   if (!bitRead(ina.operatingMode, 2) && bitRead(ina.operatingMode, 1))  // Triggered & bus active
   {
-    int16_t configRegister =
-        readWord(INA_CONFIGURATION_REGISTER, ina.address);               // Get current value
-    writeWord(INA_CONFIGURATION_REGISTER, configRegister, ina.address);  // Write to trigger next
-  }  // of if-then triggered mode enabled
+    triggerConversion();  // Write to trigger next
+  }                       // of if-then triggered mode enabled
   return (raw);
 }  // of method getBusRaw()
 int32_t INA_Class::getShuntMicroVolts(const uint8_t deviceNumber) {
@@ -619,18 +1753,19 @@ int32_t INA_Class::getShuntMicroVolts(const uint8_t deviceNumber) {
       @param[in] deviceNumber to return the value for
       @return    int32_t signed integer for the shunt microvolts
       */
-  int32_t shuntVoltage = getShuntRaw(deviceNumber);
-  if (ina.type == INA260)  // INA260 has a built-in shunt
+  int32_t shuntVoltage;
+  readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
+  if (ina.type == INA260)           // INA260 has a built-in shunt
   {
-    int32_t busMicroAmps = getBusMicroAmps(deviceNumber);  // Get the amps on the bus from device
-    shuntVoltage         = busMicroAmps / 200;             // 2mOhm resistor, convert with Ohm's law
+    int32_t busMicroAmps = currentToMicroAmps(readCurrentRegister());  // Get the amps on the bus
+    shuntVoltage         = busMicroAmps / 200;  // 2mOhm resistor, convert with Ohm's law
   } else {
-    if (ina.type == INA228) {
-      shuntVoltage = shuntVoltage * ina.shuntVoltage_LSB / 10;  // Convert to microvolts
-    } else {
-      shuntVoltage = shuntVoltage * ina.shuntVoltage_LSB / 10;  // Convert to microvolts
-    }  // if-then a INA228 with 20 bit accuracy
-  }    // of if-then-else an INA260
+    shuntVoltage = shuntToMicroVolts(readShuntRegister());  // Convert to microvolts
+  }  // of if-then-else an INA260
+  if (!bitRead(ina.operatingMode, 2) && bitRead(ina.operatingMode, 0))  // Triggered & shunt active
+  {
+    triggerConversion();  // Write to trigger next
+  }                       // of if-then triggered mode enabled
   return (shuntVoltage);
 }  // of method getShuntMicroVolts()
 int32_t INA_Class::getShuntRaw(const uint8_t deviceNumber) {
@@ -643,32 +1778,15 @@ int32_t INA_Class::getShuntRaw(const uint8_t deviceNumber) {
   readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
   if (ina.type == INA260)           // INA260 has a built-in shunt
   {
-    int32_t busMicroAmps = getBusMicroAmps(deviceNumber);  // Get the amps on the bus
-    raw                  = busMicroAmps / 200 / 1000;      // 2mOhm resistor, apply Ohm's law
+    int32_t busMicroAmps = currentToMicroAmps(readCurrentRegister());  // Get the amps on the bus
+    raw                  = busMicroAmps / 200 / 1000;  // 2mOhm resistor, apply Ohm's law
   } else {
-    if (ina.type == INA228)  // INA228 has 24 bit accuracy
-    {
-      raw = read3Bytes(ina.shuntVoltageRegister, ina.address);  // Get the raw value from register
-      // The number is two's complement, so if negative we need to pad when shifting //
-      if (raw & 0x800000) {
-        raw = (raw >> 4) | 0xFFF00000;  // first 12 bits are "1"
-      } else {
-        raw = raw >> 4;
-      }  // if-then negative
-    } else {
-      raw = readWord(ina.shuntVoltageRegister, ina.address);  // Get the raw value from register
-    }                                                         // if-then a 24 bit register
-    if (ina.type == INA3221_0 || ina.type == INA3221_1 ||
-        ina.type == INA3221_2)  // Doesn't use 3 LSB
-    {
-      raw = raw >> 3;  // shift over 3 bits, datatype is "int" so shifts in sign bits
-    }                  // of if-then we need to shift INA3221 reading over
-  }                    // of if-then-else an INA260 with inbuilt shunt
+    raw = readShuntRegister();  // Get the raw value from register
+  }                             // of if-then-else an INA260 with inbuilt shunt
   if (!bitRead(ina.operatingMode, 2) && bitRead(ina.operatingMode, 0))  // Triggered & shunt active
   {
-    int16_t configRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);  // Get current reg
-    writeWord(INA_CONFIGURATION_REGISTER, configRegister, ina.address);  // Write to trigger next
-  }  // of if-then triggered mode enabled
+    triggerConversion();  // Write to trigger next
+  }                       // of if-then triggered mode enabled
   return (raw);
 }  // of method getShuntMicroVolts()
 int32_t INA_Class::getBusMicroAmps(const uint8_t deviceNumber) {
@@ -682,19 +1800,22 @@ int32_t INA_Class::getBusMicroAmps(const uint8_t deviceNumber) {
   if (ina.type == INA3221_0 || ina.type == INA3221_1 ||
       ina.type == INA3221_2)  // Doesn't compute Amps
   {
-    microAmps =
-        (int64_t)getShuntMicroVolts(deviceNumber) * ((int64_t)1000000 / (int64_t)ina.microOhmR);
+    microAmps = currentToMicroAmps(readShuntRegister());  // Computed from the shunt voltage
   } else {
-    microAmps = (int64_t)readWord(ina.currentRegister, ina.address) * (int64_t)ina.current_LSB /
-                (int64_t)1000;
+    microAmps = currentToMicroAmps(readCurrentRegister());  // Read and convert the register
   }  // of if-then-else an INA3221
+  if (!bitRead(ina.operatingMode, 2) && bitRead(ina.operatingMode, 0))  // Triggered & shunt active
+  {
+    triggerConversion();  // Write to trigger next
+  }                       // of if-then triggered mode enabled
   return (microAmps);
 }  // of method getBusMicroAmps()
 int64_t INA_Class::getBusMicroWatts(const uint8_t deviceNumber) {
   /*!
   @brief     returns the computed microwatts measured on the bus for the specified device
   @details   The computed reading is returned and if the device is in triggered mode the next
-             conversion is started
+             conversion is started. Only the registers needed are read, the sign of the power is
+             taken from the current register and a triggered device is started exactly once
   @param[in] deviceNumber to return the value for
   @return    int64_t signed integer for computed microwatts on the bus
   */
@@ -703,20 +1824,174 @@ int64_t INA_Class::getBusMicroWatts(const uint8_t deviceNumber) {
   if (ina.type == INA3221_0 || ina.type == INA3221_1 ||
       ina.type == INA3221_2)  // Doesn't compute Amps
   {
-    microWatts =
-        ((int64_t)getShuntMicroVolts(deviceNumber) * (int64_t)1000000 / (int64_t)ina.microOhmR) *
-        (int64_t)getBusMilliVolts(deviceNumber) / (int64_t)1000;
+    int32_t shuntMicroVolts = shuntToMicroVolts(readShuntRegister());
+    int32_t busMilliVolts   = busToMilliVolts(readBusRegister());
+    microWatts = ((int64_t)shuntMicroVolts * (int64_t)1000000 / (int64_t)ina.microOhmR) *
+                 (int64_t)busMilliVolts / (int64_t)1000;
   } else {
-    microWatts =
-        (int64_t)readWord(INA_POWER_REGISTER, ina.address) * (int64_t)ina.power_LSB / (int64_t)1000;
-    if (getShuntRaw(deviceNumber) < 0) microWatts *= -1;  // Invert if negative voltage
-  }                                                       // of if-then-else an INA3221
+    int32_t currentRaw = readCurrentRegister();  // Only needed for the sign, power is unsigned
+    microWatts         = powerToMicroWatts(readPowerRegister());
+    if (currentRaw < 0) microWatts *= -1;  // Invert if negative current
+  }                                        // of if-then-else an INA3221
+  if (!bitRead(ina.operatingMode, 2) && (ina.operatingMode & B11))  // Triggered & anything active
+  {
+    triggerConversion();  // Write to trigger next
+  }                       // of if-then triggered mode enabled
   return (microWatts);
 }  // of method getBusMicroWatts()
+uint8_t INA_Class::readAll(inaReading readings[], const uint8_t arraySize) {
+  /*!
+  @brief     Reads bus voltage, shunt voltage, current and power for all devices in one call
+  @details   The array passed in is filled with one "inaReading" structure per device found by
+             "begin()", the index in the array being the device number. Each device register is read
+             exactly once, values which a device doesn't measure directly are computed from the
+             registers already read, the power from the current and bus voltage with the sign of the
+             current. As these are converted with the scale factors of "convertSamples()" they may
+             differ from the direct getters in the last digit due to rounding. The registers of a
+             device are read in one burst. Devices in triggered mode get their next conversion
+             started only once all devices have been read, and only once per physical device. The
+             devices are read with the I2C buses interleaved, see "addBus()"
+  @param[in] readings Array of at least "arraySize" elements to be filled
+  @param[in] arraySize Number of elements in the array, at most this number of devices are read
+  @return    Number of devices read into the array
+  */
+  if (!setupState()) return (0);  // No devices
+  uint8_t devices = arraySize < _DeviceCount ? arraySize : _DeviceCount;
+  readDevices(readings, devices);
+  armDevices(devices);  // Start the next batch of triggered conversions
+  return (devices);
+}  // of method readAll()
+void INA_Class::triggerAll() {
+  /*!
+  @brief     Starts a conversion on all devices in triggered mode, back-to-back
+  @details   Each physical device gets a single write of its shadowed configuration register, with
+             the I2C buses interleaved, so that all devices convert at the same time. The longest
+             conversion time of the devices is noted and "collectAll()" waits just once for it, the
+             latency of reading all devices is thereby that of one conversion and not one per
+             device. Devices in continuous mode are not touched
+  */
+  if (setupState()) armDevices(_DeviceCount);
+}  // of method triggerAll()
+uint8_t INA_Class::collectAll(inaReading readings[], const uint8_t arraySize) {
+  /*!
+  @brief     Reads all devices once the conversions started by "triggerAll()" have finished
+  @details   The call waits until the slowest conversion started by "triggerAll()" (or by
+             "readAll()") should have finished and then checks the conversion ready flag of each
+             triggered device, waiting at most another conversion time for a device which is late.
+             Then the array is filled the same way as "readAll()" does, but no new conversions are
+             started. Without a preceding "triggerAll()" the devices are read straight away. With
+             timed reads the wait is for the slowest predicted conversion and no flags are read,
+             see "setTimedReads()"
+  @param[in] readings Array of at least "arraySize" elements to be filled
+  @param[in] arraySize Number of elements in the array, at most this number of devices are read
+  @return    Number of devices read into the array
+  */
+  if (!setupState()) return (0);  // No devices
+  uint8_t devices = arraySize < _DeviceCount ? arraySize : _DeviceCount;
+  if (_BatchMicros != 0) {
+    while (micros() - _BatchStart < _BatchMicros) {
+    }  // of while the slowest conversion hasn't finished
+    for (uint8_t k = 0; k < _DeviceCount && !_timedReads; k++)  // Check each triggered device
+    {
+      uint8_t i = _PollOrder[k];
+      if (i >= devices || _DeviceState[i].chip != i) continue;  // INA3221 channels are done once
+      readInafromEEPROM(i);                                     // Load EEPROM to ina structure
+      if (bitRead(ina.operatingMode, 2) || !(ina.operatingMode & B11)) continue;  // Not triggered
+      while (!conversionReady() && micros() - _BatchStart < 2 * _BatchMicros) {
+      }  // of while conversion hasn't finished and not timed out
+    }    // of for-next each device
+    _BatchMicros = 0;  // Batch has been collected
+  }                    // of if-then a batch is pending
+  readDevices(readings, devices);
+  return (devices);
+}  // of method collectAll()
+void INA_Class::readDevices(inaReading readings[], const uint8_t devices) {
+  /*! @brief     Fill the readings array for the first "devices" devices, see "readAll()"
+      @details   Each physical device is read with the single register burst of "readChip()", all
+                 channels of an INA3221 at once, and converted as the acquisition engine's samples
+                 are, see "convertSamples()". The power is computed from the current and bus
+                 registers, so its sign is that of the current, as in "getBusMicroWatts()", and the
+                 power register isn't read. The readings of a device which couldn't be read are
+                 set to 0, see "readFailed()"
+      @param[in] readings Array of at least "devices" elements to be filled
+      @param[in] devices Number of devices to read */
+  inaRawSample samples[3];                    // One per channel of the physical device
+  for (uint8_t k = 0; k < _DeviceCount; k++)  // Loop for each device, buses interleaved
+  {
+    uint8_t i = _PollOrder[k];
+    if (i >= devices || _DeviceState[i].chip != i) continue;  // INA3221 channels are read once
+    readInafromEEPROM(i);                                     // Load EEPROM to ina structure
+    uint8_t channels = readChip(i, samples);
+    for (uint8_t ch = 0; ch < channels && i + ch < devices; ch++) {
+      convertSamples(&samples[ch], &readings[i + ch], 1);
+    }  // of for-next each channel read
+    for (uint8_t j = i; channels == 0 && j < devices && _DeviceState[j].chip == i; j++) {
+      readings[j] = inaReading();  // Failed read, zero every channel of the device
+    }  // of for-next each channel not read
+  }    // of for-next each device
+}  // of method readDevices()
+void INA_Class::armDevices(const uint8_t devices) {
+  /*! @brief     Start a conversion once on each physical device in triggered mode
+      @details   The time and the longest conversion time of the triggered devices are kept for
+                 "collectAll()"
+      @param[in] devices Only the devices numbered below this are started */
+  _BatchMicros = 0;
+  for (uint8_t k = 0; k < _DeviceCount; k++)  // Start next conversion once per physical device
+  {
+    uint8_t i = _PollOrder[k];
+    if (i >= devices || _DeviceState[i].chip != i) continue;  // INA3221 channels are done once
+    readInafromEEPROM(i);                                     // Load EEPROM to ina structure
+    if (!bitRead(ina.operatingMode, 2) && (ina.operatingMode & B11)) {
+      triggerConversion();  // Triggered mode, start next conversion
+      uint32_t cycle = _timedReads ? predictedMicros(_DeviceState[i]) : _DeviceState[i].cycleMicros;
+      if (cycle > _BatchMicros) _BatchMicros = cycle;
+    }  // of if-then triggered mode enabled
+  }    // of for-next each device
+  _BatchStart = micros();
+}  // of method armDevices()
+void INA_Class::syncRegisters(const uint8_t deviceNumber) {
+  /*!
+  @brief     Reloads the shadow copies of the configuration and mask/enable registers
+  @details   The library keeps a copy of these registers in memory so that changing settings and
+             starting triggered conversions is a single write instead of a read-modify-write. If
+             code outside of the library writes to a device then this call needs to be made so that
+             the copies match the device again. Reading the mask/enable register (DIAG_ALRT on the
+             INA228) clears the conversion-ready flag and releases a latched ALERT output, so a
+             pending conversion or alert is lost. This also happens once for all devices when the
+             runtime state is first set up, see "setupState()"
+  @param[in] deviceNumber to resynchronize (Optional, when not set all devices are reloaded)
+  */
+  if (_DeviceState == nullptr) return;        // Nothing to do before devices are enumerated
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX ? _DeviceState[i].chip == i       // All devices, INA3221 once
+                                  : deviceNumber % _DeviceCount == i)  // or just this device
+    {
+      readInafromEEPROM(i);  // Load EEPROM to ina structure
+      inaState &state      = _DeviceState[_DeviceState[i].chip];
+      state.lastPointer    = UINT8_MAX;  // Pointer unknown, force it to be written
+      state.configRegister = readWord(configAddress(), ina.address);
+      state.cycleMicros    = conversionMicros(state.configRegister);
+      switch (ina.type) {
+        case INA226:
+        case INA228:
+        case INA230:
+        case INA231:
+        case INA260: state.maskRegister = readWord(maskAddress(), ina.address); break;
+        case INA3221_0:
+        case INA3221_1:
+        case INA3221_2: state.maskRegister = readWord(INA3221_MASK_REGISTER, ina.address); break;
+        default: state.maskRegister = 0;  // Device has no mask/enable register
+      }                                   // of switch type
+    }                                     // of if this device needs to be set
+  }                                       // for-next each device loop
+}  // of method syncRegisters()
 void INA_Class::reset(const uint8_t deviceNumber) {
   /*! @brief     performs a software reset for the specified device
       @details   If no device is specified, then all devices are reset
       @param[in] deviceNumber to reset */
+  bool batching = _deferCommit;
+  _deferCommit  = true;                       // Commit the records of all devices in one go
   for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
   {
     if (deviceNumber == UINT8_MAX ||
@@ -724,10 +1999,32 @@ void INA_Class::reset(const uint8_t deviceNumber) {
     {
       readInafromEEPROM(i);  // Load EEPROM to ina structure
       writeWord(INA_CONFIGURATION_REGISTER, INA_RESET_DEVICE, ina.address);  // Set MSB  to reset
-      initDevice(i);                                                         // re-initialize device
+      if (_Ranges != nullptr) {
+        _Ranges[i].shuntOver  = INT32_MAX;  // The reset switched the shunt limits off
+        _Ranges[i].shuntUnder = INT32_MIN;
+      }  // of if-then ranges are kept
+      syncRegisters(i);  // Shadow registers now hold the reset values
+      initDevice(i);     // re-initialize device
     }  // of if this device needs to be set
   }    // for-next each device loop
+  _deferCommit = batching;
+  commitEEPROM();
 }  // of method reset
+uint16_t INA_Class::modeConfiguration(const uint16_t configRegister, const uint8_t mode) const {
+  /*! @brief     Return a configuration register of the currently loaded device with a new mode
+      @param[in] configRegister Configuration (ADC_CONFIG on the INA228) register contents
+      @param[in] mode Mode from the "ina_Mode" enumerated type
+      @return    Configuration register contents with the mode bits replaced */
+  uint16_t newRegister = configRegister;
+  if (ina.type == INA228) {  // Mode bits 12-15 in ADC_CONFIG with bus and shunt swapped
+    newRegister &= ~INA228_ADC_MODE_MASK;
+    newRegister |= (((mode & 4) << 1) | ((mode >> 1) & 1) | ((mode & 1) << 1)) << 12;
+  } else {
+    newRegister &= ~INA_CONFIG_MODE_MASK;  // zero out  mode bits
+    newRegister |= mode;                   // shift mode settings
+  }                                        // of if-then-else an INA228
+  return (newRegister);
+}  // of method modeConfiguration()
 void INA_Class::setMode(const uint8_t mode, const uint8_t deviceNumber) {
   /*!
   @brief     sets the operating mode from the list given in enum type "ina_Mode" for a device
@@ -735,31 +2032,36 @@ void INA_Class::setMode(const uint8_t mode, const uint8_t deviceNumber) {
   @param[in] mode Mode (see "ina_Mode" enumerated type for list of valid values
   @param[in] deviceNumber to reset (Optional, when not set then all devices are mode changed)
   */
-  int16_t configRegister;
+  bool batching = _deferCommit;
+  _deferCommit  = true;                       // Commit the records of all devices in one go
   for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
   {
     if (deviceNumber == UINT8_MAX ||
         deviceNumber % _DeviceCount == i)  // If this device needs setting
     {
-      readInafromEEPROM(i);  // Load EEPROM to ina structure
-      configRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);  // Get current config
-      configRegister &= ~INA_CONFIG_MODE_MASK;                             // zero out  mode bits
-      ina.operatingMode = B00000111 & mode;                                // Mask off unused bits
-      writeInatoEEPROM(i);                                                 // Store back to EEPROM
-      configRegister |= ina.operatingMode;                                 // shift mode settings
-      writeWord(INA_CONFIGURATION_REGISTER, configRegister, ina.address);  // Save new value
+      readInafromEEPROM(i);                  // Load EEPROM to ina structure
+      ina.operatingMode = B00000111 & mode;  // Mask off unused bits
+      writeInatoEEPROM(i);                   // Store back to EEPROM
+      setConfiguration(modeConfiguration(getConfiguration(), ina.operatingMode));  // Save new value
     }  // if-then this device needs to be set
   }    // for-next each device loop
+  _deferCommit = batching;
+  commitEEPROM();
 }  // of method setMode()
-bool INA_Class::conversionFinished(const uint8_t deviceNumber) {
-  /*!
-  @brief     Returns whether or not the conversion has completed
-  @details   The device's conversion ready bit is read and returned. "true" denotes finished
-             conversion.
-  @param[in] deviceNumber to check
-  */
-  if (_DeviceCount == 0) return false;             // Return finished if invalid device. Issue #65
-  readInafromEEPROM(deviceNumber % _DeviceCount);  // Load EEPROM to ina structure
+bool INA_Class::conversionReady() {
+  /*! @brief     Returns whether the currently loaded device has finished a conversion
+      @details   Reading the flag resets it (and the ALERT pin, if activated) on the device. On the
+                 devices with an ALERT pin the same read clears the latched limit and overflow
+                 flags, so for a device registered with "onAlert()" those are passed on to
+                 "decodeAlert()" rather than being lost. A flag already read by "checkAlert()" is
+                 taken from the runtime state without I2C traffic
+      @return    "true" when a conversion has finished */
+  inaState *state = currentState();
+  if (state != nullptr && state->readyPending) {  // "dispatchAlerts()" got there first
+    state->readyPending = false;
+    return (true);
+  }  // of if-then flag read already
+  uint16_t flags  = 0;
   uint16_t cvBits = 0;
   switch (ina.type) {
     case INA219:
@@ -769,58 +2071,1139 @@ bool INA_Class::conversionFinished(const uint8_t deviceNumber) {
     case INA226:
     case INA230:
     case INA231:
-    case INA260: cvBits = readWord(INA_MASK_ENABLE_REGISTER, ina.address) & (uint16_t)8; break;
+    case INA260:
+      flags  = readWord(INA_MASK_ENABLE_REGISTER, ina.address);
+      cvBits = flags & INA_CONVERSION_READY_FLAG;
+      break;
+    case INA228:
+      flags  = readWord(INA228_DIAG_ALERT_REGISTER, ina.address);
+      cvBits = flags & INA228_CONV_READY_MASK;
+      break;
     case INA3221_0:
     case INA3221_1:
     case INA3221_2: cvBits = readWord(INA3221_MASK_REGISTER, ina.address) & (uint16_t)1; break;
     default: cvBits = 1;
   }  // of switch type
-  if (cvBits != 0)
-    return (true);
-  else
-    return (false);
+  if (flags != 0 && _Alerts != nullptr && _Alerts[_currentINA].registered) {
+    uint8_t deviceNumber = _currentINA;
+    decodeAlert(deviceNumber, flags & ~cvBits);  // The conversion is reported by returning true
+    readInafromEEPROM(deviceNumber);             // The callback may have loaded another device
+  }  // of if-then alert flags to pass on
+  return (cvBits != 0);
+}  // of method conversionReady()
+bool INA_Class::resultReady() {
+  /*! @brief     Returns whether the acquisition engine may read the currently loaded device
+      @details   Once a device is due, timed reads trust the timing model and cause no I2C traffic.
+                 Devices on the ALERT line still have their flag read, as that releases the line,
+                 and so do devices without a conversion time, see "conversionMicros()"
+      @return    "true" when the result can be read */
+  if (_timedReads && !(_alertDriven && hasAlertPin(ina.type))) {
+    inaState *state = currentState();
+    if (state != nullptr && state->cycleMicros != 0) {
+      state->readyPending = false;  // Not needed, the result is due
+      return (true);
+    }  // of if-then timing known
+  }  // of if-then timed reads
+  return (conversionReady());
+}  // of method resultReady()
+bool INA_Class::hasAlertPin(const uint8_t type) const {
+  /*! @brief     Returns whether a device type can signal conversion ready on ALERT
+      @param[in] type Device type, usually that of the currently loaded device
+      @return    "true" for devices which support "alertOnConversion()" */
+  switch (type) {
+    case INA226:
+    case INA228:
+    case INA230:
+    case INA231:
+    case INA260: return (true);
+    default: return (false);
+  }  // of switch type
+}  // of method hasAlertPin()
+bool INA_Class::conversionFinished(const uint8_t deviceNumber) {
+  /*!
+  @brief     Returns whether or not the conversion has completed
+  @details   The device's conversion ready bit is read and returned. "true" denotes finished
+             conversion.
+  @param[in] deviceNumber to check
+  */
+  if (_DeviceCount == 0) return false;             // Return finished if invalid device. Issue #65
+  readInafromEEPROM(deviceNumber % _DeviceCount);  // Load EEPROM to ina structure
+  return (conversionReady());
 }  // of method "conversionFinished()"
 void INA_Class::waitForConversion(const uint8_t deviceNumber) {
   /*!
   @brief     will not return until the conversion for the specified device is finished
   @details   if no device number is specified it will wait until all devices have finished their
              current conversion. If the conversion has completed already then the flag (and
-             interrupt pin, if activated) is also reset.
+             interrupt pin, if activated) is also reset. A device which can't be read isn't waited
+             for, see "readFailed()". See "poll()" for a non-blocking way of reading devices as
+             they become ready
   @param[in] deviceNumber to reset (Optional, when not set all devices have their mode changed)
   */
-  uint16_t cvBits = 0;
   for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
   {
     if (deviceNumber == UINT8_MAX ||
         deviceNumber % _DeviceCount == i)  // If this device needs setting
     {
       readInafromEEPROM(i);  // Load EEPROM to ina structure
-      cvBits = 0;
-      while (cvBits == 0)  // Loop until the value is set
-      {
-        switch (ina.type) {
-          case INA219:
-            cvBits =
-                readWord(INA_BUS_VOLTAGE_REGISTER, ina.address) & 2;  // Bit 2 set denotes ready
-            readWord(INA_POWER_REGISTER, ina.address);                // Resets the "ready" bit
-            break;
-          case INA226:
-          case INA230:
-          case INA231:
-          case INA260:
-            cvBits = readWord(INA_MASK_ENABLE_REGISTER, ina.address) & (uint16_t)8;
-            break;
-          case INA3221_0:
-          case INA3221_1:
-          case INA3221_2:
-            cvBits = readWord(INA3221_MASK_REGISTER, ina.address) & (uint16_t)1;
-            break;
-          default: cvBits = 1;
-        }  // of switch type
-      }    // of while the conversion hasn't finished
-    }      // of if this device needs to be set
-  }        // for-next each device loop
+      bool failed = _readError;
+      _readError  = false;
+      while (!conversionReady() && !_readError) {
+      }  // of while the conversion hasn't finished and the device answers
+      _readError = _readError || failed;
+    }    // of if this device needs to be set
+  }      // for-next each device loop
 }  // of method waitForConversion()
+uint8_t INA_Class::chipRegisters(const uint8_t deviceNumber, uint8_t registers[],
+                                 uint8_t &width) const {
+  /*! @brief     List the registers which make up one sample of the currently loaded physical device
+      @details   The blocking "readChip()" and the asynchronous engine both read this list, so the
+                 same registers end up in a sample whichever path read them. An INA3221 lists the
+                 shunt and bus registers of each of its channels, the INA228 its 24-bit shunt, bus
+                 and current registers, the INA260 its current and bus registers and all other
+                 devices their shunt, bus and current registers
+      @param[in] deviceNumber Device number of the first channel, which must be loaded
+      @param[out] registers Array of INA_MAX_CHIP_REGISTERS elements to store the list in
+      @param[out] width Register width in bytes
+      @return    Number of registers listed */
+  width = 2;
+  switch (ina.type) {
+    case INA3221_0: {
+      uint8_t count = 0;
+      while (count < 6 && deviceNumber + count / 2 < _DeviceCount &&
+             _DeviceState[deviceNumber + count / 2].chip == deviceNumber) {
+        registers[count]     = INA3221_SHUNT_VOLTAGE_REGISTER + count;      // Channel shunt
+        registers[count + 1] = INA3221_SHUNT_VOLTAGE_REGISTER + count + 1;  // Channel bus
+        count += 2;
+      }  // of while-loop each channel of the chip
+      return (count);
+    }
+    case INA228:
+      width        = 3;
+      registers[0] = INA228_SHUNT_VOLTAGE_REGISTER;
+      registers[1] = INA228_BUS_VOLTAGE_REGISTER;
+      registers[2] = INA228_CURRENT_REGISTER;
+      return (3);
+    case INA260:
+      registers[0] = ina.currentRegister;
+      registers[1] = ina.busVoltageRegister;
+      return (2);
+    default:
+      registers[0] = ina.shuntVoltageRegister;
+      registers[1] = ina.busVoltageRegister;
+      registers[2] = ina.currentRegister;
+      return (3);
+  }  // of switch type
+}  // of method chipRegisters()
+uint8_t INA_Class::unpackChip(const uint8_t deviceNumber, const uint32_t values[],
+                              const uint8_t count, const uint32_t tick,
+                              inaRawSample samples[]) const {
+  /*! @brief     Turn the registers listed by "chipRegisters()" into the raw samples of each channel
+      @details   Only the device type is needed, so this works on whatever device is loaded
+      @param[in] deviceNumber Device number of the first channel
+      @param[in] values Register contents in the order "chipRegisters()" listed them
+      @param[in] count Number of registers listed
+      @param[in] tick micros() value to store in the samples
+      @param[out] samples Array with one element per channel of the device
+      @return    Number of channels unpacked */
+  uint8_t type = _DeviceState[deviceNumber].type;
+  if (type == INA3221_0) {
+    for (uint8_t ch = 0; ch < count / 2; ch++) {
+      samples[ch].deviceNumber = deviceNumber + ch;
+      samples[ch].tick         = tick;
+      samples[ch].shuntRaw     = (int16_t)values[ch * 2] >> 3;       // 3 LSB unused, shift in sign
+      samples[ch].busRaw       = (uint16_t)values[ch * 2 + 1] >> 3;  // 3 LSB unused
+      samples[ch].currentRaw   = 0;                                  // No current register
+    }  // of for-next each channel
+    return (count / 2);
+  }  // of if-then INA3221
+  samples[0].deviceNumber = deviceNumber;
+  samples[0].tick         = tick;
+  switch (type) {
+    case INA228:
+      samples[0].shuntRaw = rangedShunt(
+          deviceNumber, (values[0] & 0x800000) ? (values[0] >> 4) | 0xFFF00000 : values[0] >> 4);
+      samples[0].busRaw = values[1] >> 4;  // 20 MSB bits are the value
+      samples[0].currentRaw =
+          (values[2] & 0x800000) ? (values[2] >> 4) | 0xFFF00000 : values[2] >> 4;
+      break;
+    case INA260:
+      samples[0].shuntRaw   = 0;  // No shunt register
+      samples[0].busRaw     = (uint16_t)values[1];
+      samples[0].currentRaw = (int16_t)values[0];
+      break;
+    default:
+      samples[0].shuntRaw   = (int16_t)values[0];
+      samples[0].busRaw     = (uint16_t)values[1] >> (type == INA219 ? 3 : 0);  // 3 LSB unused
+      samples[0].currentRaw = (int16_t)values[2];
+  }  // of switch type
+  return (1);
+}  // of method unpackChip()
+uint8_t INA_Class::readChip(const uint8_t deviceNumber, inaRawSample samples[]) const {
+  /*! @brief     Read the raw samples of all channels of the currently loaded physical device
+      @details   The registers listed by "chipRegisters()" are read with one burst, see
+                 readRegisters(), so all 3 channels of an INA3221 are read together
+      @param[in] deviceNumber Device number of the first channel, which must be loaded
+      @param[out] samples Array with one element per channel of the device
+      @return    Number of channels read, 0 if a register couldn't be read */
+  uint8_t  registers[INA_MAX_CHIP_REGISTERS];
+  uint32_t values[INA_MAX_CHIP_REGISTERS];
+  uint8_t  width;
+  uint32_t tick  = micros();
+  uint8_t  count = chipRegisters(deviceNumber, registers, width);
+  if (!readRegisters(registers, count, width, values, ina.address)) return (0);
+  return (unpackChip(deviceNumber, values, count, tick, samples));
+}  // of method readChip()
+void INA_Class::convertSample(const inaRawSample &sample, inaReading &reading) {
+  /*! @brief     Convert a raw sample to bus millivolts, shunt microvolts, microamps and microwatts
+      @details   Single sample version of convertSamples()
+      @param[in] sample Raw sample as filled by readChip()
+      @param[out] reading Structure to fill with the converted values */
+  convertSamples(&sample, &reading, 1);
+}  // of method convertSample()
+void INA_Class::convertSamples(const inaRawSample samples[], inaReading readings[],
+                               const uint8_t count) const {
+  /*! @brief     Convert an array of raw samples to engineering units
+      @details   Meant to be called away from the acquisition path, such as when draining a buffer.
+                 Each value is computed with the fixed-point multiply and shift precomputed for the
+                 device in begin(), so no divisions are done and no device data is loaded. Results
+                 may differ from the direct getters in the last digit due to rounding. The power is
+                 computed from the bus voltage and current rather than read from the device, the
+                 division by 1000 being done as a multiply by 33554 / 2^25
+      @param[in] samples Array of raw samples as filled by the acquisition engine
+      @param[out] readings Array of at least "count" structures to fill with the converted values
+      @param[in] count Number of samples to convert */
+  if (_DeviceState == nullptr) return;  // begin() hasn't been called
+  for (uint8_t i = 0; i < count; i++) {
+    const inaRawSample &sample = samples[i];
+    inaReading         &reading = readings[i];
+    if (sample.deviceNumber >= _DeviceCount) continue;  // Invalid device, skip sample
+    const inaState &state = _DeviceState[sample.deviceNumber];
+    reading.timestamp     = sample.tick;
+    reading.busMilliVolts = applyScale(sample.busRaw, state.busScale);
+    switch (state.type) {
+      case INA3221_0:
+      case INA3221_1:
+      case INA3221_2:  // No current register, compute from the shunt
+        reading.shuntMicroVolts = applyScale(sample.shuntRaw, state.shuntScale);
+        reading.busMicroAmps    = applyScale(sample.shuntRaw, state.currentScale);
+        break;
+      case INA260:  // No shunt register, compute from the current
+        reading.shuntMicroVolts = applyScale(sample.currentRaw, state.shuntScale);
+        reading.busMicroAmps    = applyScale(sample.currentRaw, state.currentScale);
+        break;
+      default:
+        reading.shuntMicroVolts = applyScale(sample.shuntRaw, state.shuntScale);
+        reading.busMicroAmps    = applyScale(sample.currentRaw, state.currentScale);
+    }  // of switch type
+    reading.busMicroWatts =
+        ((int64_t)reading.busMicroAmps * (int64_t)reading.busMilliVolts * 33554) >> 25;
+  }  // of for-next each sample
+}  // of method convertSamples()
+void INA_Class::startAcquisition(const bool alertDriven) {
+  /*!
+  @brief     Starts the non-blocking acquisition engine
+  @details   After this call "poll()" needs to be called regularly from "loop()". Each call checks
+             the conversion-ready state of every device once, reads those which are ready and then
+             returns, so the program never waits for a conversion. Devices in triggered mode are
+             started here and restarted after each reading. Each device is only checked once its
+             next result is due according to its conversion times, averaging and mode, so a slow
+             device never holds up a fast one, see "nextDueMicros()".
+
+             If "alertDriven" is set then the conversion-ready alert is enabled on all devices which
+             have an ALERT pin and those devices are only checked after "alertInterrupt()" has been
+             called from the interrupt handler of the pin, saving I2C traffic. Devices without an
+             ALERT pin are always checked. If a sample period has been set with "setSamplePeriod()"
+             the devices other than an INA228 are duty cycled instead of running in their stored
+             modes.
+  @param[in] alertDriven Use the shared ALERT line to decide when to check devices
+  */
+  if (!setupState()) return;  // Nothing to do without devices
+  if (_Samples == nullptr) _Samples = new inaRawSample[_DeviceCount];  // One slot per device
+  for (uint8_t i = 0; i < _DeviceCount; i++) {
+    _DeviceState[i].sampleNew    = false;
+    _DeviceState[i].readyPending = false;
+  }  // of for-next each device
+  _alertDriven = alertDriven;
+  if (_alertDriven) alertOnConversion(true);  // Make alert pin go low on finish
+  _dutyPeriod = _samplePeriod;
+  _dutyTick   = micros() + _dutyPeriod;       // First wake-up after the first samples
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Start first conversion once per physical device
+  {
+    if (_DeviceState[i].chip != i) continue;  // INA3221 channels are started with the chip
+    readInafromEEPROM(i);                     // Load EEPROM to ina structure
+    _DeviceState[i].asleep = false;
+    if (triggeredMode()) {
+      setConfiguration(modeConfiguration(getConfiguration(), ina.operatingMode & B11));  // Starts
+      scheduleNext(_DeviceState[i], micros());  // the conversion, in triggered mode if cycling
+    } else if (_timedReads) {
+      scheduleNext(_DeviceState[i], micros());  // Settings may just have changed, wait a cycle
+    } else {
+      _DeviceState[i].dueTick = micros();  // Running already, check straight away
+    }  // of if-then-else triggered mode
+  }    // of for-next each device
+  _alertPending = _alertDriven;  // Check once, in case the line is already low
+  _acquiring    = true;
+}  // of method startAcquisition()
+void INA_Class::startAcquisition(INA_SampleBuffer &buffer, const bool alertDriven) {
+  /*!
+  @brief     Starts the acquisition engine and queues every new sample into a ring buffer
+  @details   Identical to "startAcquisition(alertDriven)", but in addition to being stored in the
+             per-device slot every sample read by "poll()" is pushed into "buffer", so that no
+             readings are lost when the consumer drains samples less often than they are produced
+  @param[in] buffer Sample ring buffer, typically an "INA_RingBuffer<N>" instance
+  @param[in] alertDriven Use the shared ALERT line to decide when to check devices
+  */
+  _SampleBuffer = &buffer;
+  startAcquisition(alertDriven);
+}  // of method startAcquisition()
+void INA_Class::stopAcquisition() {
+  /*!
+  @brief     Stops the acquisition engine started with "startAcquisition()"
+  @details   If the engine was alert driven then the conversion-ready alerts are turned off again
+  */
+  if (!_acquiring) return;
+  _acquiring    = false;
+  _SampleBuffer = nullptr;  // Stop queueing samples
+  if (_Queue != nullptr) _Queue->deviceNumber = UINT8_MAX;  // Drop any partly read device
+  _asyncNext = 0;
+  if (_alertDriven) alertOnConversion(false);  // Turn off the alerts we turned on
+  if (_dutyPeriod == 0) return;                // Devices are in their stored modes
+  _dutyPeriod = 0;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Restore the stored mode of each physical device
+  {
+    if (_DeviceState[i].chip != i) continue;  // INA3221 channels share the configuration
+    readInafromEEPROM(i);                     // Load EEPROM to ina structure
+    _DeviceState[i].asleep = false;
+    if ((ina.operatingMode & B11) && ina.type != INA228) {  // Was cycled, restore the stored mode
+      setConfiguration(modeConfiguration(getConfiguration(), ina.operatingMode));
+    }  // of if-then device not shut down
+  }    // of for-next each device
+}  // of method stopAcquisition()
+void INA_ISR_ATTR INA_Class::alertInterrupt() {
+  /*!
+  @brief     Signals the acquisition engine that the ALERT line has gone low
+  @details   This is the only library call which may be made from an interrupt handler. No I2C
+             traffic is done here, it just marks that the next "poll()" needs to check the devices
+             and that the next "dispatchAlerts()" needs to find the device which alerted. On the
+             ESP32 and ESP8266 it is placed in IRAM, as is "taskAlert()", so it can run while the
+             flash cache is disabled
+  */
+  _alertPending  = true;
+  _alertDispatch = true;
+}  // of method alertInterrupt()
+#if defined(ESP32)
+bool INA_Class::startTask(INA_SampleBuffer &buffer, const uint8_t alertPin, const uint8_t core,
+                          const uint8_t priority) {
+  /*!
+  @brief     Starts the acquisition engine in a FreeRTOS task pinned to one core of the ESP32
+  @details   The task owns the I2C bus and calls "poll()", every new sample is pushed into
+             "buffer" from where the program takes them with "pop()" or "popBatch()" without any
+             locking. If an alert pin is given the pin's interrupt handler only notifies the task,
+             which sleeps until then, otherwise the task checks the devices once every RTOS tick.
+             Any other library call made while the task runs has to be enclosed in "lock()" and
+             "unlock()" so that it doesn't interfere with the task's I2C traffic. The one task
+             serves all buses of the instance, interleaved as in "poll()". Buses which are to be
+             read in parallel need an instance each, with a task of its own, see the README
+  @param[in] buffer Sample ring buffer, typically an "INA_RingBuffer<N>" instance
+  @param[in] alertPin [optional] Pin the ALERT line is connected to, UINT8_MAX for none
+  @param[in] core [optional] Core to run the task on, default INA_TASK_CORE
+  @param[in] priority [optional] Task priority, default INA_TASK_PRIORITY
+  @return    "true" if the task was started
+  */
+  if (_Task != nullptr || _DeviceCount == 0) return (false);  // Already running or no devices
+  if (_Mutex == nullptr) _Mutex = xSemaphoreCreateRecursiveMutex();
+  if (_Mutex == nullptr) return (false);
+  _alertPin = alertPin;
+  startAcquisition(buffer, alertPin != UINT8_MAX);
+  if (xTaskCreatePinnedToCore(taskLoop, "INA", INA_TASK_STACK_SIZE, this, priority, &_Task, core) !=
+      pdPASS) {
+    _Task = nullptr;
+    stopAcquisition();
+    return (false);
+  }  // of if-then task couldn't be created
+  if (_alertPin != UINT8_MAX) {
+    pinMode(_alertPin, INPUT_PULLUP);  // The ALERT line is open-drain
+    attachInterruptArg(_alertPin, taskAlert, this, FALLING);
+  }  // of if-then alert pin used
+  return (true);
+}  // of method startTask()
+void INA_Class::stopTask() {
+  /*!
+  @brief     Stops the task started with "startTask()" and the acquisition engine
+  @details   The lock is taken first so that the task is never deleted in the middle of an I2C
+             transaction
+  */
+  if (_Task == nullptr) return;
+  if (_alertPin != UINT8_MAX) detachInterrupt(_alertPin);
+  lock();
+  vTaskDelete(_Task);
+  _Task = nullptr;
+  stopAcquisition();
+  unlock();
+}  // of method stopTask()
+bool INA_Class::lock(const uint32_t waitMillis) {
+  /*!
+  @brief     Takes the lock guarding the library against concurrent use from several tasks
+  @details   Needs to be held around any library call made while the task started by "startTask()"
+             is running. The lock is recursive, so the same task may take it more than once as long
+             as each "lock()" is matched by an "unlock()". Without a task this always succeeds
+  @param[in] waitMillis [optional] Milliseconds to wait for the lock, UINT32_MAX to wait forever
+  @return    "true" if the lock is held and "unlock()" needs to be called
+  */
+  if (_Mutex == nullptr) return (true);
+  TickType_t wait = (waitMillis == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(waitMillis);
+  return (xSemaphoreTakeRecursive(_Mutex, wait) == pdTRUE);
+}  // of method lock()
+void INA_Class::unlock() {
+  /*!
+  @brief     Releases the lock taken with "lock()"
+  */
+  if (_Mutex != nullptr) xSemaphoreGiveRecursive(_Mutex);
+}  // of method unlock()
+void INA_Class::taskLoop(void *parameter) {
+  /*!
+  @brief     Body of the FreeRTOS task started by "startTask()"
+  @details   Sleeps until the next device not signalling on the ALERT line is due, at least one
+             tick, or until the alert interrupt sends a notification. With an alert pin, devices
+             without an ALERT pin and devices powered down by "setSamplePeriod()" are still woken on
+             time, only when all devices are alert-driven does the task wait for the alert alone,
+             see "nextDueMicros()". A shared ALERT line which may still be held low is checked again
+             after one tick. Then all due devices are polled. The deadline is computed under the
+             lock, as it walks the runtime state which other calls may change, and the lock is
+             released while the task sleeps
+  @param[in] parameter Pointer to the INA_Class instance
+  */
+  INA_Class *self = static_cast<INA_Class *>(parameter);
+  for (;;) {
+    TickType_t wait = 1;  // Shared line may still be low
+    self->lock();
+    if (!self->_alertPending) {
+      uint32_t due = self->nextDueMicros();  // Alert-driven devices aren't counted
+      wait = (due == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(due / 1000);  // Earliest deadline
+      if (wait == 0) wait = 1;
+    }  // of if-then no alert pending
+    self->unlock();
+    ulTaskNotifyTake(pdTRUE, wait);
+    self->lock();
+    self->poll();  // Reads the devices and queues the samples
+    self->unlock();
+  }  // of forever loop
+}  // of method taskLoop()
+void INA_ISR_ATTR INA_Class::taskAlert(void *parameter) {
+  /*!
+  @brief     Interrupt handler of the alert pin when running as a task
+  @details   No I2C traffic is done here, the ALERT state is passed on and the task is woken
+  @param[in] parameter Pointer to the INA_Class instance
+  */
+  INA_Class *self  = static_cast<INA_Class *>(parameter);
+  BaseType_t woken = 0;
+  self->alertInterrupt();
+  vTaskNotifyGiveFromISR(self->_Task, &woken);
+  if (woken) portYIELD_FROM_ISR();  // Switch to the task straight away if it has priority
+}  // of method taskAlert()
+#endif
+uint8_t INA_Class::poll() {
+  /*!
+  @brief     Advances the acquisition engine, see "startAcquisition()"
+  @details   Every physical device is checked at most once per call. Those which have finished a
+             conversion have their bus, shunt and current registers read into the sample slot for
+             the device, from where "getSample()" retrieves them. An INA3221 has all 3 channels read
+             when it is ready. Triggered devices are restarted straight after being read. If a
+             ring buffer was passed to "startAcquisition()" each new sample is also pushed to it.
+             When devices are on several I2C buses the buses are visited in turn, so no bus has to
+             wait until all devices on another bus have been read. Devices whose next result isn't
+             due yet are skipped without any I2C traffic, this keeps the bus free for the devices
+             with short conversion times. After "setAsync(true)" each call does at most one I2C
+             transfer instead, see "setAsync()"
+  @return    Number of new samples stored in this call
+  */
+  if (!_acquiring) return 0;
+  if (_async) return (pollAsync());
+  noInterrupts();                    // Take the flag atomically
+  bool alerted  = _alertPending;     // as the interrupt handler may set it at any time
+  _alertPending = false;
+  interrupts();
+  uint8_t  samples = 0;
+  uint32_t now     = micros();
+  for (uint8_t k = 0; k < _DeviceCount; k++)  // Loop for each physical device, buses interleaved
+  {
+    uint8_t i = _PollOrder[k];
+    if (_DeviceState[i].chip != i) continue;  // INA3221 channels are read with the chip
+    readInafromEEPROM(i);                     // Load EEPROM to ina structure
+    if (!deviceDue(_DeviceState[i], now, alerted)) continue;
+    if (_DeviceState[i].asleep) {  // Duty cycle wake-up, start the next conversion
+      wakeDevice(i);
+      continue;
+    }                                              // of if-then powered down
+    if (!resultReady()) continue;                  // Not finished yet
+    uint8_t channels = readChip(i, &_Samples[i]);  // Read all channels into their slots
+    storeSamples(i, channels);
+    samples += channels;
+  }  // of for-next each device
+  if (alerted && samples) _alertPending = true;  // Other devices on a shared line may be ready
+  return (samples);
+}  // of method poll()
+void INA_Class::setAsync(const bool async) {
+  /*!
+  @brief     Spreads the I2C traffic of the acquisition engine over many calls to "poll()"
+  @details   A blocking "poll()" reads every device that is ready before it returns, which can
+             keep the processor waiting on a slow I2C bus for milliseconds. In asynchronous mode
+             each call to "poll()" does at most one I2C transfer, either the conversion-ready check
+             of the next due device or one queued register read of the device found ready, and
+             returns straight away. Once the last register of a device has been read its samples
+             are stored exactly as in blocking mode and the number of samples is returned, so
+             "poll()" can be called from a fast loop or a timer without ever holding up the
+             program for more than one register transfer. The same register list and conversions
+             are used by both modes, so the samples are identical. Any transfer in progress when
+             the mode is changed is discarded
+  @param[in] async Set to true for one I2C transfer per "poll()", false for blocking polls
+  */
+  _async = async;
+  if (_async && _Queue == nullptr) _Queue = new inaTransferQueue;  // Only needed when async
+  if (_Queue != nullptr) _Queue->deviceNumber = UINT8_MAX;         // Drop any partly read device
+  _asyncNext = 0;
+}  // of method setAsync()
+bool INA_Class::deviceDue(const inaState &state, const uint32_t now, const bool alerted) const {
+  /*! @brief     Check whether the currently loaded device should be asked if it is ready
+      @details   Alert-driven devices are due once the ALERT line was seen, all others once their
+                 next result is expected, see "scheduleNext()". No I2C traffic is caused
+      @param[in] state Runtime state of the device
+      @param[in] now micros() value to compare the deadline with
+      @param[in] alerted Set if the ALERT line has signalled since the last check
+      @return    true if the device is due */
+  if (state.asleep) return ((int32_t)(now - state.dueTick) >= 0);  // Wake-up time reached
+  if (_alertDriven && hasAlertPin(ina.type)) return (alerted);  // The ALERT line signals the result
+  return (state.cycleMicros == 0 || (int32_t)(now - state.dueTick) >= 0);
+}  // of method deviceDue()
+void INA_Class::storeSamples(const uint8_t deviceNumber, const uint8_t channels) {
+  /*! @brief     Hand the samples just read from a physical device to every consumer
+      @details   The samples are flagged for "getSample()", queued in the ring buffer, integrated
+                 and filtered as configured. Triggered devices are then restarted, or powered down
+                 until the next wake-up when duty cycling, and the next deadline of the device is
+                 set. A failed read is passed as 0 channels, nothing is stored and the sample is
+                 counted as dropped, but the device is restarted as usual so it doesn't stall
+      @param[in] deviceNumber Device number of the first channel, the device is loaded here
+      @param[in] channels Number of channels in the sample slots starting at "deviceNumber" */
+  for (uint8_t j = deviceNumber; j < deviceNumber + channels; j++) {
+    _DeviceState[j].sampleNew = true;
+    if (_SampleBuffer != nullptr) _SampleBuffer->push(_Samples[j]);  // Queue a copy as well
+    if (_Accumulators != nullptr) integrate(_Samples[j]);            // Energy and charge
+    if (_Filters != nullptr) filterSample(_Samples[j]);              // Streaming filters
+  }  // of for-next each channel of the physical device
+  inaState &state = _DeviceState[deviceNumber];
+  readInafromEEPROM(deviceNumber);                  // Load EEPROM to ina structure
+  if (_Statistics != nullptr) recordSamples(deviceNumber, channels);  // Rate and overruns
+  if (_Ranges != nullptr && channels) autoRange(deviceNumber);  // Adjust before next conversion
+  if (dutyCycled() && (ina.operatingMode & B11)) {  // Power down until the next wake-up
+    setConfiguration(modeConfiguration(getConfiguration(), INA_MODE_SHUTDOWN));
+    uint32_t now = micros();
+    if ((int32_t)(now - _dutyTick) >= 0) {  // Wake-ups are shared by all devices
+      _dutyTick += _dutyPeriod;
+      if ((int32_t)(now - _dutyTick) >= 0) _dutyTick = now + _dutyPeriod;  // Fell behind, resync
+    }  // of if-then wake-up time passed
+    state.asleep  = true;
+    state.dueTick = _dutyTick;
+  } else if (triggeredMode()) {
+    triggerConversion();
+    scheduleNext(state, micros());  // Conversion starts now
+  } else {
+    scheduleNext(state, channels ? _Samples[deviceNumber].tick : micros());  // One cycle later
+  }  // of if-then-else triggered mode
+}  // of method storeSamples()
+void INA_Class::recordSamples(const uint8_t deviceNumber, const uint8_t channels) {
+  /*! @brief     Count the samples just read from the currently loaded device in its statistics
+      @details   In the continuous modes the device keeps converting whether it is read or not, so
+                 each whole conversion time beyond the first between two samples is counted as a
+                 result which was overwritten before it was read. The conversion time comes from the
+                 timing model, see "calibrateTiming()". Triggered and duty-cycled devices only
+                 convert when started, so they can't overrun. A dropped sample, passed as 0
+                 channels, is counted with the first channel like the I2C figures
+      @param[in] deviceNumber Device number of the first channel, must be the loaded device
+      @param[in] channels Number of channels in the sample slots starting at "deviceNumber" */
+  if (channels == 0) _Statistics[deviceNumber].dropped++;
+  uint32_t cycle = 0;
+  if (!triggeredMode() && (ina.operatingMode & B11)) {
+    cycle = predictedMicros(_DeviceState[deviceNumber]);
+  }  // of if-then converting continuously
+  for (uint8_t j = deviceNumber; j < deviceNumber + channels; j++) {
+    inaStatistics &stats = _Statistics[j];
+    uint32_t       tick  = _Samples[j].tick;
+    if (stats.samples == 0) {
+      stats.firstTick = tick;
+    } else if (cycle != 0) {
+      uint32_t missed = (tick - stats.lastTick) / cycle;
+      if (missed > 1) stats.overruns += missed - 1;
+    }  // of if-then-else first sample
+    stats.lastTick = tick;
+    stats.samples++;
+  }  // of for-next each channel of the physical device
+}  // of method recordSamples()
+uint8_t INA_Class::pollAsync() {
+  /*! @brief     Do one I2C transfer of the asynchronous acquisition engine, see "setAsync()"
+      @details   While a device is queued the next of its registers is read and, after the last
+                 one, its samples are stored. Otherwise the poll order is walked from where the last
+                 call stopped until a due device is found, which is asked whether it is ready and,
+                 if so, has its registers queued. The ALERT flag is taken once per round of the
+                 poll order and kept for the whole round
+      @return    Number of new samples stored in this call */
+  if (_Queue->deviceNumber != UINT8_MAX) {  // Registers queued, read the next one
+    readInafromEEPROM(_Queue->deviceNumber);
+    if (!readRegisters(&_Queue->registers[_Queue->next], 1, _Queue->width,
+                       &_Queue->values[_Queue->next], ina.address)) {
+      _Queue->failed = true;  // The sample is dropped once all registers are done
+    }  // of if-then read failed
+    if (++_Queue->next < _Queue->count) return (0);  // More to come
+    uint8_t i            = _Queue->deviceNumber;
+    _Queue->deviceNumber = UINT8_MAX;  // Queue is free again
+    uint8_t channels     = 0;
+    if (!_Queue->failed) {
+      channels = unpackChip(i, _Queue->values, _Queue->count, _Queue->tick, &_Samples[i]);
+    }  // of if-then all registers read
+    storeSamples(i, channels);
+    return (channels);
+  }  // of if-then registers queued
+  if (_asyncNext == 0) {  // Start of a round, take the flag atomically
+    noInterrupts();
+    _asyncAlerted = _alertPending;
+    _alertPending = false;
+    interrupts();
+  }  // of if-then start of a round
+  uint32_t now = micros();
+  while (_asyncNext < _DeviceCount) {
+    uint8_t i = _PollOrder[_asyncNext++];
+    if (_DeviceState[i].chip != i) continue;  // INA3221 channels are read with the chip
+    readInafromEEPROM(i);                     // Load EEPROM to ina structure
+    if (!deviceDue(_DeviceState[i], now, _asyncAlerted)) continue;
+    if (_DeviceState[i].asleep) {  // Duty cycle wake-up, start the next conversion
+      wakeDevice(i);
+    } else if (resultReady()) {  // Queue the registers, they are read by the following calls
+      _Queue->tick         = micros();
+      _Queue->count        = chipRegisters(i, _Queue->registers, _Queue->width);
+      _Queue->next         = 0;
+      _Queue->failed       = false;
+      _Queue->deviceNumber = i;
+      if (_asyncAlerted) _alertPending = true;  // Other devices on a shared line may be ready
+    }  // of if-then ready
+    break;  // Only one check per call
+  }  // of while-loop find the next due device
+  if (_asyncNext >= _DeviceCount) _asyncNext = 0;  // Round complete
+  return (0);
+}  // of method pollAsync()
+bool INA_Class::triggeredMode() const {
+  /*! @brief     Returns whether the acquisition engine starts each conversion of the loaded device
+      @details   That is the case in the triggered modes and, while duty cycling, in the continuous
+                 modes as well, see "dutyCycled()"
+      @return    "true" if conversions are triggered by the library */
+  if (!(ina.operatingMode & B11)) return (false);  // Shut down, nothing to convert
+  return (dutyCycled() || !bitRead(ina.operatingMode, 2));
+}  // of method triggeredMode()
+bool INA_Class::dutyCycled() const {
+  /*! @brief     Returns whether the acquisition engine shuts the loaded device down between samples
+      @details   The INA228 is left in its stored mode, see "setSamplePeriod()"
+      @return    "true" while duty cycling, unless the device is an INA228 */
+  return (_dutyPeriod != 0 && ina.type != INA228);
+}  // of method dutyCycled()
+void INA_Class::wakeDevice(const uint8_t deviceNumber) {
+  /*! @brief     Start the conversion of a duty cycled device which has reached its wake-up time
+      @details   The single shadowed configuration write switches the device from shutdown to the
+                 triggered mode matching its stored mode, which starts the conversion
+      @param[in] deviceNumber Physical device to wake, must be the loaded device */
+  inaState &state = _DeviceState[deviceNumber];
+  setConfiguration(modeConfiguration(getConfiguration(), ina.operatingMode & B11));
+  state.asleep = false;
+  scheduleNext(state, micros());  // Conversion starts now
+}  // of method wakeDevice()
+void INA_Class::setSamplePeriod(const uint32_t periodMicros) {
+  /*!
+  @brief     Turns the acquisition engine into a duty-cycled, low power sampler
+  @details   With a period set, the next "startAcquisition()" takes one sample of every device
+             which isn't shut down per period, with the conversion times and averaging configured.
+             Each device is woken with a single write of the triggered mode matching its stored
+             mode, read by "poll()" once the conversion has finished and then powered down with a
+             single write of the shutdown mode until the next period starts. All devices are woken
+             together, so their samples are time-aligned. Only the shadowed configuration
+             registers are written, the stored device records are left alone, and
+             "stopAcquisition()" restores the stored modes. "nextDueMicros()" returns the time until
+             the next wake-up or result, so the processor can sleep in between as well. If a
+             conversion takes longer than the period the device is sampled every second period or
+             less often. An INA228 is left out of the duty cycle and keeps running in its stored
+             mode, read by "poll()" at the rate of its own conversions: its ENERGY and CHARGE
+             registers only accumulate while it converts, so powering it down would have them
+             miss most of each period and "getEnergyMicroJoules()" and "getChargeMicroCoulombs()"
+             under-report by about the ratio of conversion time to period
+  @param[in] periodMicros Microseconds per sample, 0 to run the devices in their stored modes
+  */
+  _samplePeriod = periodMicros;
+}  // of method setSamplePeriod()
+void INA_Class::setTimedReads(const bool timed) {
+  /*!
+  @brief     Lets the acquisition engine read devices at their predicted completion
+  @details   Normally "poll()" reads the conversion-ready flag of a device once its result is due,
+             which costs one I2C read (two on an INA219) per check and often several checks per
+             result. With timed reads the completion time is predicted from the conversion times,
+             averaging and mode in the configuration, scaled by the device's timing scale, and the
+             result is read as soon as that time has passed without reading any flag. The same
+             prediction is used by "triggerAll()" and "collectAll()". The uncalibrated scale
+             allows for a device oscillator running 12.5% slow, "calibrateTiming()" measures the
+             actual speed of each device so that the reads follow the conversions more closely.
+             Devices which signal on the ALERT line with "startAcquisition(true)" keep reading
+             their flag, as that releases the line. Takes effect with the next conversion started
+  @param[in] timed Set to true to read at the predicted time, false to read the flags
+  */
+  _timedReads = timed;
+}  // of method setTimedReads()
+uint8_t INA_Class::calibrateTiming(const uint8_t deviceNumber, const uint8_t marginPercent) {
+  /*!
+  @brief     Measures how fast each device converts compared to its data sheet timing
+  @details   One conversion of each physical device is timed with its conversion-ready flag, a
+             triggered device is started for this and a continuous one is timed from one result
+             to the next. The ratio to the nominal time plus "marginPercent" becomes the timing
+             scale used by "setTimedReads()". The margin covers the flag polling and drift with
+             temperature. This blocks for one or two conversion times per device and needs to be
+             called while the acquisition engine is stopped and after the conversion settings
+             have been made. Devices which are shut down or don't convert in time keep their scale
+  @param[in] deviceNumber [optional] Device to calibrate, all devices by default
+  @param[in] marginPercent [optional] Percent added to the measured time, INA_TIMING_MARGIN default
+  @return    Number of physical devices calibrated
+  */
+  uint8_t calibrated = 0;
+  if (!setupState()) return (0);  // No devices
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each physical device
+  {
+    if (_DeviceState[i].chip != i) continue;  // INA3221 channels share the timing
+    if (deviceNumber != UINT8_MAX && _DeviceState[deviceNumber % _DeviceCount].chip != i) continue;
+    readInafromEEPROM(i);  // Load EEPROM to ina structure
+    inaState &state   = _DeviceState[i];
+    uint32_t  timeout = 2 * state.cycleMicros;
+    if (timeout == 0) continue;  // Not converting, nothing to measure
+    uint32_t start = micros();
+    if (!bitRead(ina.operatingMode, 2)) {  // Triggered mode, start a conversion
+      conversionReady();                   // Clear a flag left from before
+      triggerConversion();
+      start = micros();
+    } else {  // Continuous mode, wait for the next result to start timing
+      conversionReady();
+      while (!conversionReady() && micros() - start < timeout) {
+      }  // of while no result
+      start = micros();
+    }  // of if-then-else triggered mode
+    bool ready = false;
+    while (!(ready = conversionReady()) && micros() - start < timeout) {
+    }  // of while the conversion hasn't finished and not timed out
+    if (!ready) continue;  // Keep the old scale
+    uint64_t scale = (uint64_t)(micros() - start) * INA_TIMING_UNITY * (100 + marginPercent) /
+                     ((uint64_t)state.cycleMicros * 100);
+    if (scale < INA_TIMING_UNITY * 3 / 4) scale = INA_TIMING_UNITY * 3 / 4;  // Implausibly fast
+    state.timingScale = scale > UINT16_MAX ? UINT16_MAX : (uint16_t)scale;
+    calibrated++;
+  }  // of for-next each device
+  return (calibrated);
+}  // of method calibrateTiming()
+uint32_t INA_Class::nextDueMicros() const {
+  /*!
+  @brief     Returns how long until the acquisition engine expects the next result of any device
+  @details   The program, or the ESP32 sampling task, can sleep this long before calling "poll()"
+             again without missing a result. Devices whose timing isn't known count as due now.
+             When the engine is alert-driven the devices signalling on the ALERT line are left out,
+             as the alert wakes the program for them, but devices without an ALERT pin and devices
+             powered down by "setSamplePeriod()" still count
+  @return    Microseconds until the earliest device is due, 0 if one is due now, UINT32_MAX if the
+             acquisition engine isn't running or only waits for the ALERT line
+  */
+  if (!_acquiring) return (UINT32_MAX);
+  if (_Queue != nullptr && _Queue->deviceNumber != UINT8_MAX) return (0);  // Async transfers
+  uint32_t now      = micros();
+  uint32_t earliest = UINT32_MAX;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each physical device
+  {
+    const inaState &state = _DeviceState[i];
+    if (state.chip != i) continue;  // INA3221 channels share the chip's schedule
+    if (_alertDriven && !state.asleep && hasAlertPin(state.type)) continue;  // ALERT wakes it
+    int32_t remaining = (int32_t)(state.dueTick - now);
+    if ((state.cycleMicros == 0 && !state.asleep) || remaining <= 0) return (0);  // Due now
+    if ((uint32_t)remaining < earliest) earliest = remaining;
+  }  // of for-next each device
+  return (earliest);
+}  // of method nextDueMicros()
+void INA_Class::resetEnergy(const uint8_t deviceNumber) {
+  /*!
+  @brief     Zeroes the energy and charge totals and starts the software integrators
+  @details   The INA228 accumulates energy and charge in hardware with every conversion, so its
+             accumulators are simply reset. All other devices have power and current integrated
+             over time by the library each time "poll()" reads a new sample, so the acquisition
+             engine needs to be running, see "startAcquisition()". The integrators use 64-bit
+             totals and only carry the fractions into them about once per joule or coulomb
+  @param[in] deviceNumber [optional] Device to reset, all devices when not specified
+  */
+  if (_DeviceCount == 0) return;
+  if (_Accumulators == nullptr) _Accumulators = new inaAccumulator[_DeviceCount]();  // Zeroed
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i)  // If device needs setting
+    {
+      readInafromEEPROM(i);  // Load EEPROM to ina structure
+      _Accumulators[i] = inaAccumulator();
+      if (ina.type == INA228) {  // Self-clearing bit in CONFIG, not in the shadowed ADC_CONFIG
+        uint16_t configRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);
+        writeWord(INA_CONFIGURATION_REGISTER, configRegister | INA228_RESET_ACCUMULATORS,
+                  ina.address);
+      }  // of if-then an INA228
+    }    // of if this device needs to be set
+  }      // of for-next each device
+}  // of method resetEnergy()
+int64_t INA_Class::getEnergyMicroJoules(const uint8_t deviceNumber) {
+  /*!
+  @brief     Returns the energy used since "resetEnergy()" for a device
+  @details   Read from the ENERGY register on the INA228, otherwise the software integrator total.
+             Divide by 3600000000 to get watt-hours
+  @param[in] deviceNumber Device to read
+  @return    Energy in microjoules (microwatt-seconds), 0 if the device has no integrator
+  */
+  if (deviceNumber >= _DeviceCount) return (0);
+  readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
+  if (ina.type == INA228) {         // Energy = 51.2 * current_LSB * ENERGY, current_LSB in nA
+    uint64_t energy = read5Bytes(INA228_ENERGY_REGISTER, ina.address);
+    return ((int64_t)(energy * ina.current_LSB / 625 * 32));  // 51.2 / 1000 is 32 / 625
+  }  // of if-then an INA228
+  if (_Accumulators == nullptr) return (0);
+  const inaAccumulator &acc = _Accumulators[deviceNumber];
+  return (acc.microJoules + acc.picoJoules / 1000000);
+}  // of method getEnergyMicroJoules()
+int64_t INA_Class::getChargeMicroCoulombs(const uint8_t deviceNumber) {
+  /*!
+  @brief     Returns the charge passed since "resetEnergy()" for a device
+  @details   Read from the CHARGE register on the INA228, otherwise the software integrator total.
+             Divide by 3600000000 to get ampere-hours. Charge flowing in the negative direction
+             through the shunt is subtracted
+  @param[in] deviceNumber Device to read
+  @return    Charge in microcoulombs (microampere-seconds), 0 if the device has no integrator
+  */
+  if (deviceNumber >= _DeviceCount) return (0);
+  readInafromEEPROM(deviceNumber);  // Load EEPROM to ina structure
+  if (ina.type == INA228) {         // Charge = current_LSB * CHARGE
+    int64_t charge = read5Bytes(INA228_CHARGE_REGISTER, ina.address);
+    if (charge & 0x8000000000LL) charge -= 0x10000000000LL;  // Sign-extend the 40 bits
+    return (charge * (int64_t)ina.current_LSB / 1000);
+  }  // of if-then an INA228
+  if (_Accumulators == nullptr) return (0);
+  const inaAccumulator &acc = _Accumulators[deviceNumber];
+  return (acc.microCoulombs + acc.picoCoulombs / 1000000);
+}  // of method getChargeMicroCoulombs()
+void INA_Class::integrate(const inaRawSample &sample) {
+  /*!
+  @brief     Adds a new sample to the energy and charge integrators of its device
+  @details   The power and current of the sample are taken as constant since the previous sample
+             of the device. The INA228 accumulates in hardware and is skipped
+  @param[in] sample Sample just read by "poll()"
+  */
+  inaAccumulator &acc = _Accumulators[sample.deviceNumber];
+  if (_DeviceState[sample.deviceNumber].type == INA228) return;  // Hardware accumulates
+  if (acc.started) {
+    inaReading reading;
+    convertSamples(&sample, &reading, 1);
+    uint32_t elapsed = sample.tick - acc.lastTick;  // micros() wraps, the difference doesn't
+    acc.picoJoules += reading.busMicroWatts * (int64_t)elapsed;
+    acc.picoCoulombs += (int64_t)reading.busMicroAmps * (int64_t)elapsed;
+    carryFraction(acc.microJoules, acc.picoJoules);
+    carryFraction(acc.microCoulombs, acc.picoCoulombs);
+  }  // of if-then a previous sample exists
+  acc.lastTick = sample.tick;
+  acc.started  = true;
+}  // of method integrate()
+void INA_Class::carryFraction(int64_t &whole, int64_t &fraction) const {
+  /*!
+  @brief     Moves the whole units out of an integrator fraction once it grows large
+  @details   This keeps the expensive 64-bit division out of the per-sample path, it is only done
+             once the fraction passes INA_INTEGRATOR_CARRY, or roughly once per joule or coulomb
+  @param[in,out] whole Total in whole micro-units
+  @param[in,out] fraction Fraction in micro-micro-units
+  */
+  if (fraction < INA_INTEGRATOR_CARRY && fraction > -INA_INTEGRATOR_CARRY) return;
+  int64_t units = fraction / 1000000;
+  whole += units;
+  fraction -= units * 1000000;
+}  // of method carryFraction()
+void INA_Class::setFilter(const uint8_t mode, const uint8_t window, const uint8_t deviceNumber) {
+  /*!
+  @brief     Sets up the streaming filter of a device
+  @details   Each sample read by "poll()" is fed to the filter of its device. INA_FILTER_AVERAGE
+             averages the samples of each window, with INA_FILTER_EMA an exponential moving
+             average with a smoothing factor of 1/window is kept. In both modes one result is
+             published per window, together with the extremes of bus voltage and current and the
+             RMS current, and is retrieved with "getFiltered()" without any I2C traffic. Only
+             integer sums, shifts and compares are done per sample, the square root for the RMS
+             value is only computed once per window. The device averaging set by "setAveraging()"
+             is applied before the library filter, so the two can be combined to get long effective
+             windows from few I2C reads. Setting INA_FILTER_NONE on all devices frees the filters
+  @param[in] mode Filter mode, see "ina_Filter"
+  @param[in] window Samples per window, rounded down to a power of 2 up to INA_FILTER_MAX_WINDOW
+  @param[in] deviceNumber [optional] Device to set, all devices when not specified
+  */
+  if (_DeviceCount == 0) return;
+  if (_Filters == nullptr) {
+    if (mode == INA_FILTER_NONE) return;      // Nothing to switch off
+    _Filters = new inaFilter[_DeviceCount]();  // Zeroed, so every device starts as NONE
+  }                                           // of if-then no filters yet
+  uint8_t shift = 0;
+  while (shift < 7 && ((uint8_t)2 << shift) <= window) shift++;  // log2, at most 128 samples
+  bool inUse = false;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i)  // If device needs setting
+    {
+      _Filters[i]       = inaFilter();
+      _Filters[i].mode  = mode;
+      _Filters[i].shift = shift;
+    }  // of if this device needs to be set
+    if (_Filters[i].mode != INA_FILTER_NONE) inUse = true;
+  }  // of for-next each device
+  if (!inUse) {
+    delete[] _Filters;
+    _Filters = nullptr;
+  }  // of if-then no device is filtered anymore
+}  // of method setFilter()
+bool INA_Class::getFiltered(const uint8_t deviceNumber, inaFilterReading &reading) {
+  /*!
+  @brief     Retrieves the latest filter result of a device, see "setFilter()"
+  @param[in] deviceNumber Device to retrieve the result for
+  @param[out] reading Structure filled with the filtered values
+  @return    "true" if a new result was available, otherwise "false" and "reading" is unchanged
+  */
+  if (_Filters == nullptr || deviceNumber >= _DeviceCount) return false;
+  if (!_Filters[deviceNumber].outputNew) return false;
+  _Filters[deviceNumber].outputNew = false;
+  reading                          = _Filters[deviceNumber].output;
+  return (true);
+}  // of method getFiltered()
+bool INA_Class::setAutoRange(const bool enabled, const uint8_t deviceNumber) {
+  /*!
+  @brief     Lets the acquisition engine switch the shunt range of an INA228 to fit the current
+  @details   The INA228 measures the shunt voltage with a 312.5nV LSB over +-163.84mV or with a
+             78.125nV LSB over +-40.96mV. "begin()" picks the range once from the maximum expected
+             current, so small currents are measured with a quarter of the possible resolution.
+             When auto-ranging, the shunt readings of the samples read by "poll()" are watched and
+             the range is switched between samples: a sample above 3/4 of the finer range selects
+             the wider range at once, the finer range is used again after INA_AUTORANGE_WINDOW
+             samples which would all have fitted into half of it. The shunt calibration register is
+             rewritten with the range, so the current and power LSB, and with them the energy and
+             charge accumulators, stay the same. The SOVL and SUVL shunt limits are rewritten too,
+             so they stay at the same voltage. The shunt values of the raw samples are stored in
+             units of the finer range whatever range was used, so the precomputed conversion factor
+             stays the same and converting a sample costs no more than before. Set this up before
+             "startAcquisition()" and "INA_SampleEncoder::writeHeader()", as it changes the scale
+             of the raw shunt values. The other devices aren't auto-ranged: the INA219 has the same
+             shunt LSB in every gain setting, the others have a single range, and on all of them
+             the current LSB set by "begin()" already resolves every step of the shunt ADC
+  @param[in] enabled Set to true to auto-range, false to go back to the range from "begin()"
+  @param[in] deviceNumber [optional] Device to set, all devices when not specified
+  @return    "true" if at least one device was set up for auto-ranging
+  */
+  if (!setupState()) return false;  // No devices
+  if (_Ranges == nullptr) {
+    if (!enabled) return false;                // Nothing to switch off
+    _Ranges = new inaRange[_DeviceCount]();  // Zeroed, so every device starts disabled
+  }                                            // of if-then no ranges yet
+  bool ranged = false, inUse = false;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i)  // If device needs setting
+    {
+      readInafromEEPROM(i);  // Load EEPROM to ina structure
+      if (ina.type == INA228) {
+        inaRange &range = _Ranges[i];
+        range.enabled   = false;
+        _currentINA     = UINT8_MAX;  // Reload to get the range chosen by "begin()"
+        readInafromEEPROM(i);
+        uint16_t config  = readWord(INA_CONFIGURATION_REGISTER, ina.address);  // Shadow copy
+        int32_t  steps   = bitRead(config, INA228_ADCRANGE_BIT) ? 4 : 1;     // Range of limits
+        int16_t  over    = readWord(INA228_SHUNT_OVER_REGISTER, ina.address);
+        int16_t  under   = readWord(INA228_SHUNT_UNDER_REGISTER, ina.address);
+        range            = inaRange();
+        range.config     = config;
+        range.shuntOver  = over == INT16_MAX ? INT32_MAX : (int32_t)over * 5 / steps;
+        range.shuntUnder = under == INT16_MIN ? INT32_MIN : (int32_t)under * 5 / steps;
+        range.enabled    = enabled;
+        applyRange(i, ina.adcRange);  // Start and end with the range from "begin()"
+        computeScales(i);
+        ranged |= enabled;
+      }  // of if-then an INA228
+    }    // of if this device needs to be set
+    if (_Ranges[i].enabled) inUse = true;
+  }  // of for-next each device
+  if (!inUse) {
+    delete[] _Ranges;
+    _Ranges = nullptr;
+  }  // of if-then no device is auto-ranged anymore
+  return (ranged);
+}  // of method setAutoRange()
+uint16_t INA_Class::ina228Calibration() const {
+  /*! @brief     Compute the shunt calibration register of the currently loaded INA228
+      @details   SHUNT_CAL = 13107.2 * 10^6 * current_LSB[A] * R[Ohm], with current_LSB in nA and R
+                 in uOhm, and 4 times that in the finer shunt range, rounded to the nearest step
+      @return    Shunt calibration register contents */
+  uint64_t calibration = (uint64_t)ina.current_LSB * ina.microOhmR * 131072;
+  if (ina.adcRange) calibration *= 4;              // 4 times finer shunt LSB, before rounding
+  calibration = (calibration + 5000000000ULL) / 10000000000ULL;  // Scale to nA * uOhm, rounded
+  if (calibration > 0x7FFF) calibration = 0x7FFF;  // 15 bit register
+  return (calibration);
+}  // of method ina228Calibration()
+void INA_Class::applyRange(const uint8_t deviceNumber, const bool fine) {
+  /*! @brief     Switch the currently loaded INA228 to one of its shunt ranges
+      @details   The ADCRANGE bit of the configuration register, the shunt calibration register and
+                 the SOVL and SUVL shunt limits, whose LSB depends on the range, are written. The
+                 configuration register comes from the shadow copy, so a switch needs no reads. The
+                 triggered modes switch between conversions, in the continuous modes the conversion
+                 in progress may still finish in the old range
+      @param[in] deviceNumber Device to program, must be the loaded device
+      @param[in] fine Set for the +-40.96mV range, clear for the +-163.84mV range */
+  inaRange &range = _Ranges[deviceNumber];
+  range.fine      = fine;
+  ina.adcRange    = fine;
+  bitWrite(range.config, INA228_ADCRANGE_BIT, fine);  // Select the shunt range
+  writeWord(INA_CONFIGURATION_REGISTER, range.config, ina.address);
+  writeWord(INA228_SHUNT_CAL_REGISTER, ina228Calibration(), ina.address);
+  writeShuntLimit(deviceNumber, true, range.shuntOver);  // Same limits in the new LSB
+  writeShuntLimit(deviceNumber, false, range.shuntUnder);
+}  // of method applyRange()
+void INA_Class::autoRange(const uint8_t deviceNumber) {
+  /*! @brief     Check the sample just read from the currently loaded device and switch its shunt
+                 range if needed, see "setAutoRange()"
+      @param[in] deviceNumber Device the sample is from, must be the loaded device */
+  inaRange &range = _Ranges[deviceNumber];
+  if (!range.enabled) return;
+  int32_t        shunt = _Samples[deviceNumber].shuntRaw;  // In units of the finer range
+  uint32_t       level = shunt < 0 ? -shunt : shunt;
+  const uint32_t full  = INA228_CURRENT_STEPS;  // Full scale of the finer range, 2^19
+  if (range.fine) {
+    if (level > full / 4 * 3) applyRange(deviceNumber, false);  // Close to the top, widen at once
+    return;
+  }  // of if-then in the finer range
+  if (level > range.peak) range.peak = level;
+  if (++range.count < INA_AUTORANGE_WINDOW) return;  // Window not complete yet
+  if (range.peak < full / 2) applyRange(deviceNumber, true);
+  range.peak  = 0;
+  range.count = 0;
+}  // of method autoRange()
+int32_t INA_Class::rangedShunt(const uint8_t deviceNumber, const int32_t raw) const {
+  /*! @brief     Convert a raw shunt register value of an auto-ranged INA228 to the units of the
+                 finer range
+      @details   Values of devices which aren't auto-ranged are returned unchanged
+      @param[in] deviceNumber Device the value was read from
+      @param[in] raw Raw shunt voltage register contents
+      @return    Raw shunt voltage in units of 78.125nV when auto-ranged */
+  if (_Ranges == nullptr || !_Ranges[deviceNumber].enabled || _Ranges[deviceNumber].fine) {
+    return (raw);
+  }  // of if-then no conversion needed
+  return (raw * 4);
+}  // of method rangedShunt()
+void INA_Class::filterSample(const inaRawSample &sample) {
+  /*!
+  @brief     Adds a new sample to the streaming filter of its device
+  @details   Averages are kept as sums (INA_FILTER_AVERAGE) or as EMA values scaled by the window
+             length (INA_FILTER_EMA), so both are turned into results with the same shift. The mean
+             square of the current has each term shifted before it is added so that it cannot
+             overflow 64 bits
+  @param[in] sample Sample just read by "poll()"
+  */
+  inaFilter &filter = _Filters[sample.deviceNumber];
+  if (filter.mode == INA_FILTER_NONE) return;
+  inaReading reading;
+  convertSamples(&sample, &reading, 1);
+  uint64_t square = (int64_t)reading.busMicroAmps * reading.busMicroAmps;
+  if (filter.count == 0) {  // First sample of the window sets the extremes
+    filter.window.minBusMilliVolts = filter.window.maxBusMilliVolts = reading.busMilliVolts;
+    filter.window.minBusMicroAmps = filter.window.maxBusMicroAmps = reading.busMicroAmps;
+  } else {
+    if (reading.busMilliVolts < filter.window.minBusMilliVolts)
+      filter.window.minBusMilliVolts = reading.busMilliVolts;
+    if (reading.busMilliVolts > filter.window.maxBusMilliVolts)
+      filter.window.maxBusMilliVolts = reading.busMilliVolts;
+    if (reading.busMicroAmps < filter.window.minBusMicroAmps)
+      filter.window.minBusMicroAmps = reading.busMicroAmps;
+    if (reading.busMicroAmps > filter.window.maxBusMicroAmps)
+      filter.window.maxBusMicroAmps = reading.busMicroAmps;
+  }  // of if-then-else first sample of the window
+  if (filter.mode == INA_FILTER_EMA && filter.started) {  // sum += x - sum / window
+    filter.sumMilliVolts += reading.busMilliVolts - (filter.sumMilliVolts >> filter.shift);
+    filter.sumShunt += reading.shuntMicroVolts - (filter.sumShunt >> filter.shift);
+    filter.sumMicroAmps += reading.busMicroAmps - (filter.sumMicroAmps >> filter.shift);
+    filter.sumMicroWatts += reading.busMicroWatts - (filter.sumMicroWatts >> filter.shift);
+    filter.meanSquare += (int64_t)(square - filter.meanSquare) >> filter.shift;
+  } else if (filter.mode == INA_FILTER_EMA) {  // Seed with the first sample to avoid a slow start
+    filter.sumMilliVolts = (uint32_t)reading.busMilliVolts << filter.shift;
+    filter.sumShunt      = (int64_t)reading.shuntMicroVolts * ((int32_t)1 << filter.shift);
+    filter.sumMicroAmps  = (int64_t)reading.busMicroAmps * ((int32_t)1 << filter.shift);
+    filter.sumMicroWatts = reading.busMicroWatts * ((int32_t)1 << filter.shift);
+    filter.meanSquare    = square;
+    filter.started       = true;
+  } else {  // Plain sums, cleared once per window
+    filter.sumMilliVolts += reading.busMilliVolts;
+    filter.sumShunt += reading.shuntMicroVolts;
+    filter.sumMicroAmps += reading.busMicroAmps;
+    filter.sumMicroWatts += reading.busMicroWatts;
+    filter.meanSquare += square >> filter.shift;
+  }  // of if-then-else filter mode
+  filter.window.average.timestamp = sample.tick;
+  if (++filter.count >> filter.shift) publishFilter(filter);  // Window is complete
+}  // of method filterSample()
+void INA_Class::publishFilter(inaFilter &filter) const {
+  /*!
+  @brief     Turns the sums of a complete filter window into the result for "getFiltered()"
+  @param[in,out] filter Filter of the device, the window is restarted
+  */
+  filter.window.average.busMilliVolts   = filter.sumMilliVolts >> filter.shift;
+  filter.window.average.shuntMicroVolts = filter.sumShunt >> filter.shift;
+  filter.window.average.busMicroAmps    = filter.sumMicroAmps >> filter.shift;
+  filter.window.average.busMicroWatts   = filter.sumMicroWatts >> filter.shift;
+  filter.window.rmsBusMicroAmps         = squareRoot(filter.meanSquare);
+  filter.output                         = filter.window;
+  filter.outputNew                      = true;
+  filter.count                          = 0;
+  if (filter.mode == INA_FILTER_AVERAGE) {  // The EMA values carry over into the next window
+    filter.sumMilliVolts = 0;
+    filter.sumShunt      = 0;
+    filter.sumMicroAmps  = 0;
+    filter.sumMicroWatts = 0;
+    filter.meanSquare    = 0;
+  }  // of if-then a window average
+}  // of method publishFilter()
+uint32_t INA_Class::squareRoot(uint64_t value) const {
+  /*!
+  @brief     Integer square root, rounded down
+  @details   Computed bit by bit with shifts, adds and compares only
+  @param[in] value Value to take the square root of
+  @return    Largest integer whose square does not exceed "value"
+  */
+  uint64_t root = 0;
+  uint64_t bit  = (uint64_t)1 << 62;  // Highest power of 4 in 64 bits
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }  // of if-then-else bit is set in the root
+    bit >>= 2;
+  }  // of while-loop each bit pair
+  return ((uint32_t)root);
+}  // of method squareRoot()
+bool INA_Class::getSample(const uint8_t deviceNumber, inaReading &reading) {
+  /*!
+  @brief     Retrieves the latest sample read by the acquisition engine for a device
+  @details   The raw values stored by "poll()" are converted here, so that the conversion cost is
+             only paid for samples which are actually used
+  @param[in] deviceNumber Device to retrieve the sample for
+  @param[out] reading Structure filled with the converted values
+  @return    "true" if a new sample was available, otherwise "false" and "reading" is unchanged
+  */
+  if (_Samples == nullptr || deviceNumber >= _DeviceCount) return false;
+  if (!_DeviceState[deviceNumber].sampleNew) return false;
+  _DeviceState[deviceNumber].sampleNew = false;
+  convertSample(_Samples[deviceNumber], reading);
+  return (true);
+}  // of method getSample()
 bool INA_Class::alertOnConversion(const bool alertState, const uint8_t deviceNumber) {
   /*!
   @brief     configures the INA devices which support this functionality to pull the ALERT pin low
@@ -843,10 +3226,16 @@ bool INA_Class::alertOnConversion(const bool alertState, const uint8_t deviceNum
         case INA230:
         case INA231:
         case INA260:
-          alertRegister = readWord(INA_MASK_ENABLE_REGISTER, ina.address);      // Get register
+          alertRegister = getMaskEnable();                                      // Get register
           alertRegister &= INA_ALERT_MASK;                                      // Mask off all bits
           if (alertState) bitSet(alertRegister, INA_ALERT_CONVERSION_RDY_BIT);  // Turn on the bit
-          writeWord(INA_MASK_ENABLE_REGISTER, alertRegister, ina.address);      // Write back
+          setMaskEnable(alertRegister);                                         // Write back
+          returnCode = true;
+          break;
+        case INA228:
+          alertRegister = getMaskEnable();  // Other alert settings are kept
+          bitWrite(alertRegister, INA228_ALERT_CONV_RDY_BIT, alertState);
+          setMaskEnable(alertRegister);
           returnCode = true;
           break;
         default: returnCode = false;
@@ -860,7 +3249,10 @@ bool INA_Class::alertOnShuntOverVoltage(const bool alertState, const int32_t mil
   /*!
   @brief     configures the INA devices which support this functionality to pull the ALERT pin low
              when the shunt current exceeds the value given in the parameter in millivolts
-  @details   This call is ignored and returns false when called for an invalid device
+  @details   This call is ignored and returns false when called for an invalid device. The INA228
+             has a register per limit, so its limits can be armed together. Its shunt limits are
+             scaled for the ADC range in use and written again by each switch of an auto-ranged
+             device, see "setAutoRange()"
   @param[in] alertState Boolean true or false to denote the requested setting
   @param[in] milliVolts alert level at which to trigger the alarm
   @param[in] deviceNumber to reset (Optional, when not set all devices have their mode changed)
@@ -877,15 +3269,19 @@ bool INA_Class::alertOnShuntOverVoltage(const bool alertState, const int32_t mil
         case INA226:
         case INA230:
         case INA231:
-          alertRegister = readWord(INA_MASK_ENABLE_REGISTER, ina.address);  // Get current register
+          alertRegister = getMaskEnable();                                  // Get current register
           alertRegister &= INA_ALERT_MASK;                                  // Mask off all bits
           if (alertState)  // If true, then also set threshold
           {
-            bitSet(alertRegister, INA_ALERT_SHUNT_OVER_VOLT_BIT);           // Turn on the bit
-            uint16_t threshold = milliVolts * 1000 / ina.shuntVoltage_LSB;  // Compute using LSB
-            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);    // Write register
+            bitSet(alertRegister, INA_ALERT_SHUNT_OVER_VOLT_BIT);             // Turn on the bit
+            uint16_t threshold = milliVolts * 1000 / ina.shuntVoltage_LSB();  // Compute using LSB
+            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);      // Write register
           }  // of if we are setting a value
-          writeWord(INA_MASK_ENABLE_REGISTER, alertRegister, ina.address);  // Write register back
+          setMaskEnable(alertRegister);                                     // Write register back
+          returnCode = true;
+          break;
+        case INA228:
+          writeShuntLimit(i, true, alertState ? (int64_t)milliVolts * 1000 : INT32_MAX);
           returnCode = true;
           break;
         default: returnCode = false;
@@ -899,7 +3295,8 @@ bool INA_Class::alertOnShuntUnderVoltage(const bool alertState, const int32_t mi
   /*!
   @brief     configures the INA devices which support this functionality to pull the ALERT pin low
              when the shunt current goes below the value given in the parameter in millivolts
-  @details   This call is ignored and returns false when called for an invalid device
+  @details   This call is ignored and returns false when called for an invalid device. On the
+             INA228 the limit goes to SUVL, see "alertOnShuntOverVoltage()"
   @param[in] alertState Boolean true or false to denote the requested setting
   @param[in] milliVolts alert level at which to trigger the alarm
   @param[in] deviceNumber to reset (Optional, when not set all devices have their alert changed)
@@ -916,15 +3313,18 @@ bool INA_Class::alertOnShuntUnderVoltage(const bool alertState, const int32_t mi
         case INA226:
         case INA230:
         case INA231:
-          alertRegister = readWord(INA_MASK_ENABLE_REGISTER, ina.address);  // Get current register
+          alertRegister = getMaskEnable();                                  // Get current register
           alertRegister &= INA_ALERT_MASK;                                  // Mask off all bits
           if (alertState)                                                   // Also set threshold
           {
-            bitSet(alertRegister, INA_ALERT_SHUNT_UNDER_VOLT_BIT);          // Turn on the bit
-            uint16_t threshold = milliVolts * 1000 / ina.shuntVoltage_LSB;  // Compute using LSB
-            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);    // Write register
+            bitSet(alertRegister, INA_ALERT_SHUNT_UNDER_VOLT_BIT);            // Turn on the bit
+            uint16_t threshold = milliVolts * 1000 / ina.shuntVoltage_LSB();  // Compute using LSB
+            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);      // Write register
           }  // of if we are setting a value
-          writeWord(INA_MASK_ENABLE_REGISTER, alertRegister, ina.address);  // Write register back
+          setMaskEnable(alertRegister);                                     // Write register back
+          break;
+        case INA228:
+          writeShuntLimit(i, false, alertState ? (int64_t)milliVolts * 1000 : INT32_MIN);
           break;
         default: returnCode = false;
       }  // of switch type
@@ -937,7 +3337,8 @@ bool INA_Class::alertOnBusOverVoltage(const bool alertState, const int32_t milli
   /*!
   @brief     configures the INA devices which support this functionality to pull the ALERT pin low
              when the bus voltage goes above the value given in the parameter in millivolts
-  @details   This call is ignored and returns false when called for an invalid device
+  @details   This call is ignored and returns false when called for an invalid device. On the
+             INA228 the limit goes to BOVL and switching it off writes the reset value back
   @param[in] alertState Boolean true or false to denote the requested setting
   @param[in] milliVolts alert level at which to trigger the alarm
   @param[in] deviceNumber to reset (Optional, when not set all devices have their alert changed)
@@ -956,16 +3357,19 @@ bool INA_Class::alertOnBusOverVoltage(const bool alertState, const int32_t milli
         case INA230:
         case INA231:
         case INA260:
-          alertRegister =
-              readWord(INA_MASK_ENABLE_REGISTER, ina.address);  // Get the current register
+          alertRegister = getMaskEnable();                      // Get the current register
           alertRegister &= INA_ALERT_MASK;                      // Mask off all bits
           if (alertState)                                       // Also set threshold
           {
-            bitSet(alertRegister, INA_ALERT_BUS_OVER_VOLT_BIT);           // Turn on the bit
-            uint16_t threshold = milliVolts * 100 / ina.busVoltage_LSB;   // Compute using LSB val
-            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);  // Write register
+            bitSet(alertRegister, INA_ALERT_BUS_OVER_VOLT_BIT);            // Turn on the bit
+            uint16_t threshold = milliVolts * 100 / ina.busVoltage_LSB();  // Compute using LSB val
+            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);   // Write register
           }  // of if we are setting a value
-          writeWord(INA_MASK_ENABLE_REGISTER, alertRegister, ina.address);  // Write register back
+          setMaskEnable(alertRegister);                                     // Write register back
+          break;
+        case INA228:  // BOVL LSB is 3.125mV
+          writeLimit(INA228_BUS_OVER_REGISTER,
+                     alertState ? (int64_t)milliVolts * 8 / 25 : INT16_MAX, 0, INT16_MAX);
           break;
         default: returnCode = false;
       }  // of switch type
@@ -978,7 +3382,8 @@ bool INA_Class::alertOnBusUnderVoltage(const bool alertState, const int32_t mill
   /*!
   @brief     configures the INA devices which support this functionality to pull the ALERT pin
              low when the bus current goes above the value given in the parameter in millivolts.
-  @details   This call is ignored and returns false when called for an invalid device
+  @details   This call is ignored and returns false when called for an invalid device. On the
+             INA228 the limit goes to BUVL and switching it off writes the reset value of 0 back
   @param[in] alertState Boolean true or false to denote the requested setting
   @param[in] milliVolts alert level at which to trigger the alarm
   @param[in] deviceNumber to reset (Optional, when not set then all devices have their alert
@@ -997,15 +3402,19 @@ bool INA_Class::alertOnBusUnderVoltage(const bool alertState, const int32_t mill
         case INA230:
         case INA231:
         case INA260:
-          alertRegister = readWord(INA_MASK_ENABLE_REGISTER, ina.address);  // Get current register
+          alertRegister = getMaskEnable();                                  // Get current register
           alertRegister &= INA_ALERT_MASK;                                  // Mask off all bits
           if (alertState)                                                   // Also set threshold
           {
-            bitSet(alertRegister, INA_ALERT_BUS_UNDER_VOLT_BIT);          // Turn on the bit
-            uint16_t threshold = milliVolts * 100 / ina.busVoltage_LSB;   // Compute using LSB val
-            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);  // Write register
+            bitSet(alertRegister, INA_ALERT_BUS_UNDER_VOLT_BIT);           // Turn on the bit
+            uint16_t threshold = milliVolts * 100 / ina.busVoltage_LSB();  // Compute using LSB val
+            writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);   // Write register
           }  // of if we are setting a value
-          writeWord(INA_MASK_ENABLE_REGISTER, alertRegister, ina.address);  // Write register back
+          setMaskEnable(alertRegister);                                     // Write register back
+          break;
+        case INA228:  // BUVL LSB is 3.125mV
+          writeLimit(INA228_BUS_UNDER_REGISTER, alertState ? (int64_t)milliVolts * 8 / 25 : 0, 0,
+                     INT16_MAX);
           break;
         default: returnCode = false;
       }  // of switch type
@@ -1018,7 +3427,8 @@ bool INA_Class::alertOnPowerOverLimit(const bool alertState, const int32_t milli
   /*!
   @brief     configures the INA devices which support this functionality to pull the ALERT pin
              low when the power exceeds the value set in the parameter in milliamps
-  @details   This call is ignored and returns false when called for an invalid device
+  @details   This call is ignored and returns false when called for an invalid device. On the
+             INA228 the limit goes to PWR_LIMIT, whose LSB is 256 times the power LSB
   @param[in] alertState Boolean true or false to denote the requested setting
   @param[in] milliAmps alert level at which to trigger the alarm
   @param[in] deviceNumber to reset (Optional, when not set all devices have their alert changed)
@@ -1037,15 +3447,21 @@ bool INA_Class::alertOnPowerOverLimit(const bool alertState, const int32_t milli
         case INA230:
         case INA231:
         case INA260:  // Devices with alert pin
-          alertRegister = readWord(INA_MASK_ENABLE_REGISTER, ina.address);  // Get current register
+          alertRegister = getMaskEnable();                                  // Get current register
           alertRegister &= INA_ALERT_MASK;                                  // Mask off all bits
           if (alertState)                                                   // Also set threshold
           {
             bitSet(alertRegister, INA_ALERT_POWER_OVER_WATT_BIT);         // Turn on the bit
-            uint16_t threshold = milliAmps * 1000000 / ina.power_LSB;     // Compute using LSB val
+            uint16_t threshold = milliAmps * 1000000 / ina.power_LSB();   // Compute using LSB val
             writeWord(INA_ALERT_LIMIT_REGISTER, threshold, ina.address);  // Write register
           }  // of if we are setting a value
-          writeWord(INA_MASK_ENABLE_REGISTER, alertRegister, ina.address);  // Write register back
+          setMaskEnable(alertRegister);                                     // Write register back
+          break;
+        case INA228:  // PWR_LIMIT LSB is 256 times the power LSB
+          writeLimit(INA228_POWER_LIMIT_REGISTER,
+                     alertState ? (int64_t)milliAmps * 1000000 / ((int64_t)ina.power_LSB() * 256)
+                                : UINT16_MAX,
+                     0, UINT16_MAX);
           break;
         default: returnCode = false;
       }  // of switch type
@@ -1053,6 +3469,279 @@ bool INA_Class::alertOnPowerOverLimit(const bool alertState, const int32_t milli
   }      // for-next each device loop
   return (returnCode);
 }  // of method AlertOnPowerOverLimit
+bool INA_Class::onAlert(inaAlertCallback callback, const uint8_t deviceNumber) {
+  /*!
+  @brief     Registers a function to be called when a device pulls the shared ALERT line low
+  @details   The alert output of the device is switched to latched mode, so that the ALERT line
+             stays low and the cause stays readable until "dispatchAlerts()" has read it. The limit
+             itself is still set with the "alertOn...()" functions. A nullptr callback only latches
+             the causes for "getAlertCause()". Only registered devices have their alert flags read
+             by "dispatchAlerts()". The INA228 limits are armed with the same functions and are
+             reported with the same causes, but have no hysteresis, see "setAlertHysteresis()"
+  @param[in] callback Function to call, gets the device number and the INA_ALERT_CAUSE bits
+  @param[in] deviceNumber [optional] Device to register for, all devices when not specified
+  @return    "true" if at least one of the devices has an ALERT pin
+  */
+  if (!setupState()) return (false);  // No devices
+  if (_Alerts == nullptr) _Alerts = new inaAlert[_DeviceCount]();  // Zeroed, no callbacks
+  bool returnCode = false;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i)  // If device needs setting
+    {
+      readInafromEEPROM(i);  // Load EEPROM to ina structure
+      if (!hasAlertPin(ina.type)) continue;
+      _Alerts[i].callback   = callback;
+      _Alerts[i].registered = true;  // Even without a callback, the causes are latched
+      uint16_t alertRegister = getMaskEnable();
+      bitSet(alertRegister, ina.type == INA228 ? INA228_ALERT_LATCH_BIT : INA_ALERT_LATCH_BIT);
+      setMaskEnable(alertRegister);
+      returnCode = true;
+    }  // of if this device needs to be set
+  }    // of for-next each device
+  return (returnCode);
+}  // of method onAlert()
+void INA_Class::setAlertHysteresis(const uint8_t percent, const uint8_t deviceNumber) {
+  /*!
+  @brief     Sets the hysteresis used to re-arm a voltage limit after it has alerted
+  @details   When a shunt or bus voltage limit alerts, the device is switched to the opposite limit
+             moved back by "percent" of the original limit. The ALERT line is therefore quiet until
+             the reading has come back past the hysteresis, which is reported with
+             INA_ALERT_CAUSE_REARMED, and the original limit is then restored. This needs the single
+             alert limit of the INA226, INA230, INA231 and INA260. The power limit has no opposite
+             and is re-armed straight away. Call "onAlert()" first
+  @param[in] percent Hysteresis in percent of the limit, 0 re-arms straight away
+  @param[in] deviceNumber [optional] Device to set, all devices when not specified
+  */
+  if (_Alerts == nullptr) return;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i) _Alerts[i].percent = percent;
+  }  // of for-next each device
+}  // of method setAlertHysteresis()
+void INA_Class::setAlertResponse(const bool useAlertResponse) {
+  /*!
+  @brief     Selects whether "dispatchAlerts()" uses the SMBus Alert Response Address
+  @details   With the ARA the alerting devices answer with their own address, lowest address first,
+             so only their registers need to be read. Without it every registered device has its
+             mask/enable register read. Buses with a multiplexer are always read device by device
+  @param[in] useAlertResponse "true" to use the ARA
+  */
+  _alertResponse = useAlertResponse;
+}  // of method setAlertResponse()
+uint8_t INA_Class::dispatchAlerts() {
+  /*!
+  @brief     Finds the devices which pulled the ALERT line low, latches the causes and calls back
+  @details   To be called from "loop()". Nothing is done, and no I2C traffic happens, unless
+             "alertInterrupt()" has been called since the last call. Only the mask/enable (DIAG_ALRT
+             on the INA228) registers are read, which also releases the latched ALERT output. While
+             the acquisition engine is running the conversion-ready alerts are left to "poll()" and
+             "poll()" passes on any limit alert it finds when it reads the conversion-ready flag
+  @return    Number of devices which had alerted
+  */
+  if (_Alerts == nullptr) return (0);
+  noInterrupts();                   // Take the flag atomically
+  bool alerted   = _alertDispatch;  // as the interrupt handler may set it at any time
+  _alertDispatch = false;
+  interrupts();
+  if (!alerted) return (0);
+  uint8_t fired = 0;
+  for (uint8_t b = 0; b < _BusCount; b++)  // Identify the devices on each bus
+  {
+    bool useResponse = _alertResponse && _MuxAddress[b] == 0;  // ARA can't see behind the mux
+    for (uint8_t n = 0; useResponse && n < _DeviceCount; n++)  // One device answers per request
+    {
+      uint8_t address = alertResponse(b);
+      if (address == 0) break;  // No device is holding the line anymore
+      uint8_t i = 0;
+      while (i < _DeviceCount) {
+        readInafromEEPROM(i);
+        if (ina.bus == b && ina.address == address && _DeviceState[i].chip == i) break;
+        i++;
+      }  // of while-loop look for the device
+      if (i == _DeviceCount || !_Alerts[i].registered) break;  // Not a device we may read
+      if (!checkAlert(i)) break;                                // Nothing to release
+      fired++;
+    }  // of for-next each response
+    if (useResponse) continue;  // All devices on the bus have been identified
+    for (uint8_t i = 0; i < _DeviceCount; i++)  // Otherwise read each registered device on the bus
+    {
+      if (_DeviceState[i].chip != i || !_Alerts[i].registered) continue;  // See onAlert()
+      readInafromEEPROM(i);
+      if (ina.bus == b && checkAlert(i)) fired++;
+    }  // of for-next each device
+  }    // of for-next each bus
+  return (fired);
+}  // of method dispatchAlerts()
+uint8_t INA_Class::getAlertCause(const uint8_t deviceNumber) const {
+  /*!
+  @brief     Returns the alert causes latched for a device since the last "clearAlert()"
+  @param[in] deviceNumber Device to check
+  @return    INA_ALERT_CAUSE bits, 0 if the device hasn't alerted
+  */
+  if (_Alerts == nullptr || deviceNumber >= _DeviceCount) return (0);
+  return (_Alerts[deviceNumber].cause);
+}  // of method getAlertCause()
+void INA_Class::clearAlert(const uint8_t deviceNumber) {
+  /*!
+  @brief     Clears the latched alert causes of a device, see "getAlertCause()"
+  @param[in] deviceNumber [optional] Device to clear, all devices when not specified
+  */
+  if (_Alerts == nullptr) return;
+  for (uint8_t i = 0; i < _DeviceCount; i++)  // Loop for each device found
+  {
+    if (deviceNumber == UINT8_MAX || deviceNumber % _DeviceCount == i) _Alerts[i].cause = 0;
+  }  // of for-next each device
+}  // of method clearAlert()
+uint8_t INA_Class::alertResponse(const uint8_t bus) const {
+  /*!
+  @brief     Reads the SMBus Alert Response Address on a bus
+  @param[in] bus Bus to read
+  @return    7-bit address of the device which answered, 0 if no device answered
+  */
+  INA_COUNT(i2cTransactions, 1);
+  if (_Bus[bus]->requestFrom(INA_ALERT_RESPONSE_ADDRESS, (uint8_t)1) != 1) return (0);
+  INA_COUNT(i2cBytes, 1);
+  return ((uint8_t)_Bus[bus]->read() >> 1);  // Address is sent in the upper 7 bits
+}  // of method alertResponse()
+bool INA_Class::checkAlert(const uint8_t deviceNumber) {
+  /*!
+  @brief     Reads the alert flags of a device and dispatches any alert found
+  @details   Called with the device loaded. Reading the flags releases the latched ALERT output and
+             clears the conversion-ready flag. While the acquisition engine is running that flag is
+             kept in the runtime state, so that "poll()" still reads the result
+  @param[in] deviceNumber Device to check
+  @return    "true" if the device had alerted
+  */
+  if (!hasAlertPin(ina.type)) return (false);
+  uint16_t flags;
+  uint16_t ready;
+  if (ina.type == INA228) {
+    flags = readWord(INA228_DIAG_ALERT_REGISTER, ina.address);
+    ready = INA228_CONV_READY_MASK;
+  } else {
+    flags = readWord(INA_MASK_ENABLE_REGISTER, ina.address);
+    ready = INA_CONVERSION_READY_FLAG;
+  }  // of if-then-else an INA228
+  if (_acquiring && (flags & ready)) {
+    _DeviceState[deviceNumber].readyPending = true;  // See conversionReady()
+    flags &= ~ready;                                 // and reported by poll(), not as an alert
+  }  // of if-then engine running
+  return (decodeAlert(deviceNumber, flags));
+}  // of method checkAlert()
+bool INA_Class::decodeAlert(const uint8_t deviceNumber, const uint16_t flags) {
+  /*!
+  @brief     Decodes the alert flags read from a device and dispatches any alert found
+  @details   Called with the device loaded by "checkAlert()" and "conversionReady()", which both
+             read the register holding the flags. The limit causes are latched, the hysteresis
+             limit is re-armed if set and the callback is called
+  @param[in] deviceNumber Device the flags were read from
+  @param[in] flags Mask/enable (DIAG_ALRT on the INA228) register contents
+  @return    "true" if the device had alerted
+  */
+  inaAlert &alert   = _Alerts[deviceNumber];
+  uint16_t  enabled = getMaskEnable();  // Shadow copy, no I2C
+  uint8_t   cause   = 0;
+  if (ina.type == INA228) {
+    cause = limitCause(flags, 6);  // SHNTOL, SHNTUL, BUSOL, BUSUL and POL in bits 6-2
+    if (flags & INA228_MATH_OVERFLOW_FLAG) cause |= INA_ALERT_CAUSE_OVERFLOW;
+    if (bitRead(enabled, INA228_ALERT_CONV_RDY_BIT) && (flags & INA228_CONV_READY_MASK))
+      cause |= INA_ALERT_CAUSE_CONVERSION;
+  } else {
+    if (flags & INA_ALERT_FUNCTION_FLAG) cause = limitCause(enabled, 15);  // Armed function
+    if (flags & INA_ALERT_OVERFLOW_FLAG) cause |= INA_ALERT_CAUSE_OVERFLOW;
+    if (bitRead(enabled, INA_ALERT_CONVERSION_RDY_BIT) && (flags & INA_CONVERSION_READY_FLAG))
+      cause |= INA_ALERT_CAUSE_CONVERSION;
+  }  // of if-then-else an INA228
+  if (cause == 0) return (false);
+  const uint8_t voltageCauses{INA_ALERT_CAUSE_SHUNT_OVER | INA_ALERT_CAUSE_SHUNT_UNDER |
+                              INA_ALERT_CAUSE_BUS_OVER | INA_ALERT_CAUSE_BUS_UNDER};
+  if (ina.type != INA228 && (cause & voltageCauses) && (alert.percent || alert.rearming)) {
+    rearmAlert(alert, cause);  // Swap between the limit and its hysteresis limit
+    if (!alert.rearming) cause = INA_ALERT_CAUSE_REARMED | limitCause(alert.function, 15);
+  }  // of if-then a voltage limit with hysteresis
+  if (!(cause & INA_ALERT_CAUSE_REARMED)) alert.cause |= cause;  // Latch the cause
+  if (alert.callback != nullptr) alert.callback(deviceNumber, cause);
+  return (true);
+}  // of method decodeAlert()
+uint8_t INA_Class::limitCause(const uint16_t flags, const uint8_t topBit) const {
+  /*!
+  @brief     Maps 5 consecutive limit bits onto the INA_ALERT_CAUSE bits
+  @details   All devices order the bits shunt over, shunt under, bus over, bus under and power over
+             from the top bit down
+  @param[in] flags Register contents
+  @param[in] topBit Bit holding the shunt over-voltage flag
+  @return    INA_ALERT_CAUSE bits
+  */
+  uint8_t cause = 0;
+  for (uint8_t b = 0; b < 5; b++)
+    if (bitRead(flags, topBit - b)) cause |= (uint8_t)1 << b;
+  return (cause);
+}  // of method limitCause()
+void INA_Class::writeLimit(const uint8_t limitRegister, const int64_t value, const int32_t lowest,
+                           const int32_t highest) const {
+  /*!
+  @brief     Writes one of the INA228 limit registers of the currently loaded device
+  @details   The INA228 compares each limit register all the time, so a limit is switched off by
+             writing its reset value, which is the end of the range the reading can't pass
+  @param[in] limitRegister Limit register to write
+  @param[in] value Limit in register LSBs, clamped to the range of the register
+  @param[in] lowest Lowest value the register holds
+  @param[in] highest Highest value the register holds
+  */
+  int64_t limit = value < lowest ? lowest : (value > highest ? highest : value);
+  writeWord(limitRegister, (uint16_t)limit, ina.address);
+}  // of method writeLimit()
+void INA_Class::writeShuntLimit(const uint8_t deviceNumber, const bool over,
+                                const int64_t microVolts) {
+  /*!
+  @brief     Writes the SOVL or SUVL register of the currently loaded INA228 in the ADC range used
+  @details   The LSB is 5uV, or 1.25uV with ADCRANGE. The limit is kept in microvolts, so that
+             "applyRange()" can write it again when an auto-ranged device switches its range
+  @param[in] deviceNumber Device to write, must be the loaded device
+  @param[in] over Set for SOVL, clear for SUVL
+  @param[in] microVolts Limit, INT32_MAX (SOVL) or INT32_MIN (SUVL) to switch it off
+  */
+  int32_t limit =
+      microVolts < INT32_MIN ? INT32_MIN : (microVolts > INT32_MAX ? INT32_MAX : microVolts);
+  if (_Ranges != nullptr) {
+    (over ? _Ranges[deviceNumber].shuntOver : _Ranges[deviceNumber].shuntUnder) = limit;
+  }  // of if-then ranges are kept
+  writeLimit(over ? INA228_SHUNT_OVER_REGISTER : INA228_SHUNT_UNDER_REGISTER,
+             (int64_t)limit * (ina.adcRange ? 4 : 1) / 5, INT16_MIN, INT16_MAX);
+}  // of method writeShuntLimit()
+void INA_Class::rearmAlert(inaAlert &alert, const uint8_t cause) {
+  /*!
+  @brief     Switches a device between its voltage limit and the hysteresis limit opposite to it
+  @details   Called with the device loaded when a shunt or bus voltage limit alerted. The first
+             time the opposite limit, moved back by the hysteresis, is armed. When that alerts the
+             limit set by the user is restored
+  @param[in,out] alert Alert dispatch state of the device
+  @param[in] cause INA_ALERT_CAUSE bits of the alert
+  */
+  uint16_t alertRegister = getMaskEnable();
+  if (alert.rearming) {  // Reading is back past the hysteresis, restore the user's limit
+    writeWord(INA_ALERT_LIMIT_REGISTER, alert.limit, ina.address);
+    setMaskEnable((alertRegister & ~INA_ALERT_FUNCTION_MASK) | alert.function);
+    alert.rearming = false;
+    return;
+  }  // of if-then re-arming
+  alert.function   = alertRegister & INA_ALERT_FUNCTION_MASK;
+  alert.limit      = readWord(INA_ALERT_LIMIT_REGISTER, ina.address);
+  bool     over    = cause & (INA_ALERT_CAUSE_SHUNT_OVER | INA_ALERT_CAUSE_BUS_OVER);
+  bool     shunt   = cause & (INA_ALERT_CAUSE_SHUNT_OVER | INA_ALERT_CAUSE_SHUNT_UNDER);
+  int32_t  limit   = shunt ? (int32_t)(int16_t)alert.limit : (int32_t)alert.limit;
+  int32_t  delta   = (limit < 0 ? -limit : limit) * alert.percent / 100;
+  uint16_t reverse = over ? alert.function >> 1 : alert.function << 1;  // Over and under swap
+  limit += over ? -delta : delta;
+  int32_t lowest  = shunt ? INT16_MIN : 0;  // Shunt limit is signed, bus limit unsigned
+  int32_t highest = shunt ? INT16_MAX : UINT16_MAX;
+  if (limit < lowest) limit = lowest;
+  if (limit > highest) limit = highest;
+  writeWord(INA_ALERT_LIMIT_REGISTER, (uint16_t)limit, ina.address);
+  setMaskEnable((alertRegister & ~INA_ALERT_FUNCTION_MASK) | reverse);
+  alert.rearming = true;
+}  // of method rearmAlert()
 void INA_Class::setAveraging(const uint16_t averages, const uint8_t deviceNumber) {
   /*!
   @brief     sets the hardware averaging for one or all devices
@@ -1068,7 +3757,7 @@ void INA_Class::setAveraging(const uint16_t averages, const uint8_t deviceNumber
         deviceNumber % _DeviceCount == i)  // If this device needs setting
     {
       readInafromEEPROM(i);                                                // Load EEPROM to struct
-      configRegister = readWord(INA_CONFIGURATION_REGISTER, ina.address);  // Get current register
+      configRegister = getConfiguration();  // Get current register
       switch (ina.type) {
         case INA219:
           if (averages >= 128)
@@ -1117,8 +3806,248 @@ void INA_Class::setAveraging(const uint16_t averages, const uint8_t deviceNumber
           configRegister &= ~INA226_CONFIG_AVG_MASK;  // zero out the averages part
           configRegister |= averageIndex << 9;        // shift in the averages to reg
           break;
+        case INA228:  // Same averaging steps as the INA226 in bits 0-2 of ADC_CONFIG
+          if (averages >= 1024)
+            averageIndex = 7;
+          else if (averages >= 512)
+            averageIndex = 6;
+          else if (averages >= 256)
+            averageIndex = 5;
+          else if (averages >= 128)
+            averageIndex = 4;
+          else if (averages >= 64)
+            averageIndex = 3;
+          else if (averages >= 16)
+            averageIndex = 2;
+          else if (averages >= 4)
+            averageIndex = 1;
+          else
+            averageIndex = 0;
+          configRegister &= ~INA228_ADC_AVG_MASK;  // zero out the averages part
+          configRegister |= averageIndex;          // averages are in the lowest bits
+          break;
       }                                                                    // of switch type
-      writeWord(INA_CONFIGURATION_REGISTER, configRegister, ina.address);  // Save new value
+      setConfiguration(configRegister);                                    // Save new value
     }  // of if this device needs to be set
   }    // for-next each device loop
 }  // of method setAveraging()
+void INA_WireTransport::begin() {
+  /*! @brief     Start the bus, see "TwoWire::begin()" */
+  _bus->begin();
+}  // of method begin()
+void INA_WireTransport::setClock(const uint32_t clock) {
+  /*! @brief     Set the bus speed, see "TwoWire::setClock()"
+      @param[in] clock Bus speed in Hz */
+  _bus->setClock(clock);
+}  // of method setClock()
+void INA_WireTransport::beginTransmission(const uint8_t address) {
+  /*! @brief     Start a write to a device, see "TwoWire::beginTransmission()"
+      @param[in] address I2C address of the device */
+  _bus->beginTransmission(address);
+}  // of method beginTransmission()
+uint8_t INA_WireTransport::write(const uint8_t data) {
+  /*! @brief     Queue a byte to write, see "TwoWire::write()"
+      @param[in] data Byte to write
+      @return    Number of bytes queued */
+  return (_bus->write(data));
+}  // of method write()
+uint8_t INA_WireTransport::endTransmission(const bool sendStop) {
+  /*! @brief     Send the queued bytes, see "TwoWire::endTransmission()"
+      @param[in] sendStop Release the bus afterwards, false for a repeated start
+      @return    0 on success, otherwise the TwoWire error code */
+  return (_bus->endTransmission(sendStop));
+}  // of method endTransmission()
+uint8_t INA_WireTransport::requestFrom(const uint8_t address, const uint8_t count) {
+  /*! @brief     Read bytes from a device, see "TwoWire::requestFrom()"
+      @param[in] address I2C address of the device
+      @param[in] count Number of bytes to read
+      @return    Number of bytes received */
+  return (_bus->requestFrom(address, count));
+}  // of method requestFrom()
+int INA_WireTransport::read() {
+  /*! @brief     Return the next byte received, see "TwoWire::read()"
+      @return    Byte read, -1 if there is none */
+  return (_bus->read());
+}  // of method read()
+INA_SampleBuffer::INA_SampleBuffer(inaRawSample *storage, const uint8_t mask)
+    : _storage(storage), _mask(mask) {
+  /*!
+  @brief     Class constructor, called from the "INA_RingBuffer" template with its storage
+  @param[in] storage Array of (mask + 1) samples
+  @param[in] mask Capacity - 1, the capacity being a power of 2
+  */
+}  // of class constructor
+bool INA_SampleBuffer::push(const inaRawSample &sample) {
+  /*!
+  @brief     Adds a sample to the buffer, only to be called by the producer
+  @details   The sample is copied into the slot before the head index is advanced, with a memory
+             barrier between the two so that the consumer never sees a partly written sample. The
+             indices are free running 8-bit values, their difference is the number of samples held
+  @param[in] sample Sample to add
+  @return    "false" if the buffer was full and the sample was dropped, otherwise "true"
+  */
+  uint8_t head = _head;
+  if ((uint8_t)(head - _tail) > _mask) {  // Buffer is full, count and drop sample
+    _dropped = _dropped + 1;
+    return false;
+  }  // of if-then buffer full
+  _storage[head & _mask] = sample;
+  INA_MEMORY_BARRIER();  // Slot must be written before the index is published
+  _head = head + 1;
+  return true;
+}  // of method push()
+bool INA_SampleBuffer::pop(inaRawSample &sample) {
+  /*!
+  @brief      Removes the oldest sample from the buffer, only to be called by the consumer
+  @param[out] sample Structure to copy the sample into
+  @return     "false" if the buffer was empty, otherwise "true"
+  */
+  return popBatch(&sample, 1) == 1;
+}  // of method pop()
+uint8_t INA_SampleBuffer::popBatch(inaRawSample samples[], const uint8_t maxSamples) {
+  /*!
+  @brief      Removes up to "maxSamples" of the oldest samples, only to be called by the consumer
+  @details    The head index is only read once, so all samples available at the start of the call
+              are copied out before the tail index is advanced in a single step
+  @param[out] samples Array to copy the samples into
+  @param[in]  maxSamples Size of the "samples" array
+  @return     Number of samples copied
+  */
+  uint8_t tail  = _tail;
+  uint8_t count = _head - tail;
+  INA_MEMORY_BARRIER();  // Read index before the slots it covers
+  if (count > maxSamples) count = maxSamples;
+  for (uint8_t i = 0; i < count; i++) samples[i] = _storage[(uint8_t)(tail + i) & _mask];
+  INA_MEMORY_BARRIER();  // Slots must be copied before they are released to the producer
+  _tail = tail + count;
+  return count;
+}  // of method popBatch()
+uint8_t INA_SampleBuffer::available() const {
+  /*!
+  @brief     Returns the number of samples currently held in the buffer
+  @return    Number of samples which can be popped
+  */
+  return (uint8_t)(_head - _tail);
+}  // of method available()
+uint16_t INA_SampleBuffer::dropped() const {
+  /*!
+  @brief     Returns the number of samples dropped because the buffer was full
+  @details   The value is not reset, the caller can compare successive values
+  @return    Number of samples dropped since the buffer was created
+  */
+  return _dropped;
+}  // of method dropped()
+INA_SampleEncoder::INA_SampleEncoder(Print &output, inaRawSample *storage, const uint8_t devices)
+    : _output(output), _storage(storage), _devices(devices) {
+  /*!
+  @brief     Class constructor, called from the "INA_StreamEncoder" template with its storage
+  @param[in] output Destination of the stream, such as "Serial" or an open SD card file
+  @param[in] storage Array of "devices" samples holding the previous values
+  @param[in] devices Number of devices the storage holds
+  */
+}  // of class constructor
+size_t INA_SampleEncoder::writeHeader(INA_Class &ina) {
+  /*!
+  @brief     Write the stream header with the calibration of each device
+  @details   The header format is described with the class. The differences start over, so a
+             header can be written at the start of each new file. Devices beyond the number the
+             encoder was declared with are left out
+  @param[in] ina Library instance the devices were found with
+  @return    Number of bytes written
+  */
+  inaDeviceInfo info;
+  uint8_t       count = 0;
+  while (count < _devices && ina.getDeviceInfo(count, info)) count++;  // Devices to describe
+  reset();
+  size_t written = _output.write('I');
+  written += _output.write('N');
+  written += _output.write('A');
+  written += _output.write(INA_STREAM_VERSION);
+  written += _output.write(count);
+  for (uint8_t i = 0; i < count; i++) {
+    ina.getDeviceInfo(i, info);
+    written += _output.write(info.type);
+    written += _output.write(info.address);
+    written += writeFixed(info.busVoltage_LSB, 2);
+    written += writeFixed(info.shuntVoltage_LSB, 2);
+    written += writeFixed(info.current_LSB, 4);
+    written += writeFixed(info.power_LSB, 4);
+    written += writeFixed(info.microOhmR, 4);
+    written += writeScale(info.busScale);
+    written += writeScale(info.shuntScale);
+    written += writeScale(info.currentScale);
+  }  // of for-next each device
+  return (written);
+}  // of method writeHeader()
+size_t INA_SampleEncoder::encode(const inaRawSample &sample) {
+  /*!
+  @brief     Write one raw sample as a record of differences to the previous one
+  @param[in] sample Raw sample as returned by "getSample()" or an "INA_SampleBuffer"
+  @return    Number of bytes written, 0 if the device number is beyond the encoder's storage
+  */
+  if (sample.deviceNumber >= _devices) return (0);
+  inaRawSample &previous = _storage[sample.deviceNumber];
+  size_t        written  = writeVarint(sample.deviceNumber);
+  written += writeVarint(sample.tick - _lastTick);  // Wraps around along with micros()
+  written += writeSigned((int32_t)(sample.busRaw - previous.busRaw));
+  written += writeSigned(sample.shuntRaw - previous.shuntRaw);
+  written += writeSigned(sample.currentRaw - previous.currentRaw);
+  _lastTick = sample.tick;
+  previous  = sample;
+  return (written);
+}  // of method encode()
+size_t INA_SampleEncoder::encode(const inaRawSample samples[], const uint8_t count) {
+  /*!
+  @brief     Write an array of raw samples, such as those returned by "popBatch()"
+  @param[in] samples Array of raw samples
+  @param[in] count Number of samples in the array
+  @return    Number of bytes written
+  */
+  size_t written = 0;
+  for (uint8_t i = 0; i < count; i++) written += encode(samples[i]);
+  return (written);
+}  // of method encode()
+void INA_SampleEncoder::reset() {
+  /*!
+  @brief     Start the differences over from 0, as at the start of a stream
+  @details   Called by "writeHeader()", a decoder starts from 0 after each header
+  */
+  for (uint8_t i = 0; i < _devices; i++) {
+    _storage[i].busRaw     = 0;
+    _storage[i].shuntRaw   = 0;
+    _storage[i].currentRaw = 0;
+  }  // of for-next each device
+  _lastTick = 0;
+}  // of method reset()
+size_t INA_SampleEncoder::writeVarint(uint32_t value) {
+  /*! @brief     Write an unsigned value 7 bits per byte, least significant first
+      @param[in] value Value to write
+      @return    Number of bytes written */
+  size_t written = 0;
+  while (value > 0x7F) {
+    written += _output.write((uint8_t)(value | 0x80));  // More bytes follow
+    value >>= 7;
+  }  // of while-loop more than 7 bits left
+  return (written + _output.write((uint8_t)value));
+}  // of method writeVarint()
+size_t INA_SampleEncoder::writeSigned(const int32_t value) {
+  /*! @brief     Write a signed value as a zigzag varint, so small negative values stay short
+      @param[in] value Value to write
+      @return    Number of bytes written */
+  return (writeVarint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31)));
+}  // of method writeSigned()
+size_t INA_SampleEncoder::writeFixed(uint32_t value, const uint8_t bytes) {
+  /*! @brief     Write the lowest bytes of a value, least significant first
+      @param[in] value Value to write
+      @param[in] bytes Number of bytes to write
+      @return    Number of bytes written */
+  size_t written = 0;
+  for (uint8_t i = 0; i < bytes; i++, value >>= 8) written += _output.write((uint8_t)value);
+  return (written);
+}  // of method writeFixed()
+size_t INA_SampleEncoder::writeScale(const inaScale &scale) {
+  /*! @brief     Write a scale factor as its multiplier and shift
+      @param[in] scale Scale factor to write
+      @return    Number of bytes written */
+  return (writeFixed(scale.mult, 4) + _output.write(scale.shift));
+}  // of method writeScale()
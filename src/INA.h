@@ -94,6 +94,36 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 | Version | Date       | Developer   | Comments
 | ------- | ---------- | ----------- | --------
+| 1.2.0   | 2026-10-14 | agent       | Per-device statistics and I2C retries, see getStatistics()
+| 1.2.0   | 2026-10-14 | agent       | INA228 shunt auto-ranging, see setAutoRange()
+| 1.2.0   | 2026-10-14 | agent       | Conversion timing model, see setTimedReads()
+| 1.2.0   | 2026-10-14 | agent       | Duty-cycled acquisition with setSamplePeriod()
+| 1.2.0   | 2026-10-14 | agent       | Compare-before-write storage, setDeferredCommit() and commit()
+| 1.2.0   | 2026-10-14 | agent       | Type LSBs in PROGMEM, device records trimmed to devices found
+| 1.2.0   | 2026-10-14 | agent       | Binary delta/varint sample stream, see INA_SampleEncoder
+| 1.2.0   | 2026-10-14 | agent       | Batch acquisition with triggerAll() and collectAll()
+| 1.2.0   | 2026-10-14 | agent       | Pluggable I2C transport and the INA_Simulator register model
+| 1.2.0   | 2026-10-14 | agent       | Asynchronous acquisition, one I2C transfer per poll() call
+| 1.2.0   | 2026-10-14 | agent       | Optional I2C/EEPROM traffic counters, see INA_COUNTERS
+| 1.2.0   | 2026-10-14 | agent       | Alert dispatch with callbacks, latched causes, hysteresis, ARA
+| 1.2.0   | 2026-10-14 | agent       | Deadline scheduling of devices from their conversion times
+| 1.2.0   | 2026-10-14 | agent       | Streaming average, EMA and min/max/RMS filters with decimation
+| 1.2.0   | 2026-10-14 | agent       | Complete INA228 support, fixed-point conversions without divides
+| 1.2.0   | 2026-10-14 | agent       | Energy and charge from the INA228 accumulators or integrated
+| 1.2.0   | 2026-10-14 | agent       | ESP32 sampling task with startTask(), lock() and unlock()
+| 1.2.0   | 2026-10-14 | agent       | TCA9548A multiplexer support, device storage grows as needed
+| 1.2.0   | 2026-10-14 | agent       | Devices on several I2C buses, see addBus()
+| 1.2.0   | 2026-10-14 | agent       | begin() scans then configures with one EEPROM commit, resume()
+| 1.2.0   | 2026-10-14 | agent       | I2C delay set with setI2CSpeed(), skip unchanged pointer writes
+| 1.2.0   | 2026-10-14 | agent       | Burst register reads for INA3221 channels and INA228
+| 1.2.0   | 2026-10-14 | agent       | Compile-time configured "INA_Device" templates in INA_Device.h
+| 1.2.0   | 2026-10-14 | agent       | Batch conversion of raw samples with fixed-point scale factors
+| 1.2.0   | 2026-10-14 | agent       | Lock-free sample ring buffer for the acquisition engine
+| 1.2.0   | 2026-10-14 | agent       | Non-blocking acquisition engine with poll() and alertInterrupt()
+| 1.2.0   | 2026-10-14 | agent       | Shadow copies of configuration and mask/enable registers
+| 1.2.0   | 2026-10-14 | agent       | Single register read and re-trigger in power, shunt and current getters
+| 1.2.0   | 2026-10-14 | agent       | Added readAll() to read all devices in one call
+| 1.2.0   | 2026-10-14 | agent       | Optional RAM cache of decoded device structures
 | 1.1.2   | 2022-01-16 | Oleg-Sob    | Issue #87. getBusMicroWatts() only returns positive values
 | 1.1.1   | 2021-03-12 | x3mEr       | Issue #79. Documentation Update
 | 1.0.14  | 2020-12-01 | SV-Zanshin  | Issue #72. Allow INA structures to be in memory rather than EEPROM
@@ -164,6 +194,11 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 #ifndef INA__Class_h
 /*! Guard code definition to prevent multiple includes */
 #define INA__Class_h
+#ifndef INA_COUNTERS
+  /*! Set to 1 here or with a compiler flag to count I2C and EEPROM traffic, see getCounters() */
+  #define INA_COUNTERS 0
+#endif
+class TwoWire;  // Forward declaration, the I2C library is only included in the implementation
 /*! typedef contains a packed bit-level defs of information stored per device */
 typedef struct {
   uint8_t  type : 4;           ///< 0-15        see enumerated "ina_Type" for details
@@ -171,19 +206,146 @@ typedef struct {
   uint32_t address : 7;        ///< 0-127       I2C Address of device
   uint32_t maxBusAmps : 10;    ///< 0-1023      Store initialization value
   uint32_t microOhmR : 20;     ///< 0-1,048,575 Store initialization value
+  uint32_t bus : 2;            ///< 0-3         I2C bus the device is on, see "addBus()"
+  uint32_t muxChannel : 4;     ///< 0-8         Multiplexer channel + 1, 0 if none, see "addMux()"
 } inaEEPROM;                   // of structure
+/*! typedef contains the header stored in EEPROM ahead of the device records, see "resume()" */
+typedef struct {
+  uint8_t signature;    ///< INA_EEPROM_SIGNATURE when the records below are valid
+  uint8_t recordSize;   ///< sizeof(inaEEPROM) at the time the records were written
+  uint8_t deviceCount;  ///< Number of device records stored
+} inaHeader;            // of structure
 /*! typedef contains a packed bit-level definition of information stored on a device */
 typedef struct inaDet : inaEEPROM {
   uint8_t  busVoltageRegister : 3;    ///< 0- 7, Bus Voltage Register
   uint8_t  shuntVoltageRegister : 3;  ///< 0- 7, Shunt Voltage Register
   uint8_t  currentRegister : 3;       ///< 0- 7, Current Register
-  uint16_t shuntVoltage_LSB;          ///< Device dependent LSB factor
-  uint16_t busVoltage_LSB;            ///< Device dependent LSB factor
+  uint8_t  adcRange : 1;              ///< 0- 1, INA228 ADCRANGE, set for the +-40.96mV range
   uint32_t current_LSB;               ///< Amperage LSB
-  uint32_t power_LSB;                 ///< Wattage LSB
   inaDet();                           ///< struct constructor
   inaDet(inaEEPROM& inaEE);           ///< for ina = inaEE; assignment
+  uint16_t shuntVoltage_LSB() const;  ///< Device dependent LSB factor, from flash
+  uint16_t busVoltage_LSB() const;    ///< Device dependent LSB factor, from flash
+  uint32_t power_LSB() const;         ///< Wattage LSB, derived from the amperage LSB
 } inaDet;                             // of structure
+/*! typedef contains one complete set of converted measurements for a device, see "readAll()" */
+typedef struct {
+  uint16_t busMilliVolts;    ///< Bus voltage in millivolts
+  int32_t  shuntMicroVolts;  ///< Shunt voltage in microvolts
+  int32_t  busMicroAmps;     ///< Bus current in microamps
+  int64_t  busMicroWatts;    ///< Bus power in microwatts
+  uint32_t timestamp;        ///< micros() value when the device was read
+} inaReading;                // of structure
+/*! typedef contains one set of unconverted register values for a device, see "poll()" */
+typedef struct {
+  uint8_t  deviceNumber;  ///< Device number the sample was read from
+  uint32_t busRaw;        ///< Raw bus voltage register, right-aligned
+  int32_t  shuntRaw;      ///< Raw shunt voltage register, sign-extended. 0 on the INA260
+  int32_t  currentRaw;    ///< Raw current register. 0 on the INA3221 which has no such register
+  uint32_t tick;          ///< micros() value when the device was read
+} inaRawSample;           // of structure
+/*! typedef contains a fixed-point scale factor, the converted value is (raw * mult) >> shift */
+typedef struct {
+  uint32_t mult;   ///< Multiplier
+  uint8_t  shift;  ///< Right shift applied to the product
+  bool     wide;   ///< Set if the product needs 64 bits, otherwise 32 bits suffice
+} inaScale;        // of structure
+/*! typedef contains the calibration of a device needed to convert its raw samples, see
+    "getDeviceInfo()" */
+typedef struct {
+  uint8_t  type;              ///< Device type, see enumerated "ina_Type" for details
+  uint8_t  address;           ///< I2C address of the device
+  uint16_t busVoltage_LSB;    ///< Device dependent LSB factor
+  uint16_t shuntVoltage_LSB;  ///< Device dependent LSB factor
+  uint32_t current_LSB;       ///< Amperage LSB
+  uint32_t power_LSB;         ///< Wattage LSB
+  uint32_t microOhmR;         ///< Shunt resistance in micro-ohm
+  inaScale busScale;          ///< Raw bus reading to millivolts
+  inaScale shuntScale;        ///< Raw shunt (current on INA260) reading to microvolts
+  inaScale currentScale;      ///< Raw current (shunt on INA3221) reading to microamps
+} inaDeviceInfo;              // of structure
+/*! typedef contains the runtime state of a device which is only kept in RAM and never stored */
+typedef struct {
+  uint16_t configRegister;  ///< Shadow copy of the last configuration register value
+  uint16_t maskRegister;    ///< Shadow copy of the last mask/enable register value
+  uint8_t  chip;            ///< Device number holding the state of the physical device (INA3221)
+  bool     sampleNew;       ///< Set when the acquisition engine has a sample not yet retrieved
+  uint8_t  type;            ///< Copy of the device type, so conversions needn't load the device
+  inaScale busScale;        ///< Raw bus reading to millivolts
+  inaScale shuntScale;      ///< Raw shunt (current on INA260) reading to microvolts
+  inaScale currentScale;    ///< Raw current (shunt on INA3221) reading to microamps
+  inaScale powerScale;      ///< Raw power register reading to microwatts
+  uint8_t  lastPointer;     ///< Last register pointer written to the device, UINT8_MAX if unknown
+  uint32_t cycleMicros;     ///< Microseconds per result from the configuration, 0 if unknown
+  uint32_t dueTick;         ///< micros() value at which the next result is expected
+  bool     recordDirty;     ///< Device record changed in the cache but not stored, see commit()
+  bool     asleep;          ///< Powered down until "dueTick", see setSamplePeriod()
+  uint16_t timingScale;     ///< Conversion time relative to nominal, INA_TIMING_UNITY is 1:1
+  bool     readyPending;    ///< Conversion-ready flag read by "checkAlert()", left for "poll()"
+} inaState;                 // of structure
+/*! typedef contains the software energy and charge integrators of a device, see "resetEnergy()" */
+typedef struct {
+  int64_t  microJoules;    ///< Whole microjoules accumulated
+  int64_t  microCoulombs;  ///< Whole microcoulombs accumulated
+  int64_t  picoJoules;     ///< Fraction not yet carried, in microwatt-microseconds
+  int64_t  picoCoulombs;   ///< Fraction not yet carried, in microamp-microseconds
+  uint32_t lastTick;       ///< micros() value of the previous sample
+  bool     started;        ///< Set once the first sample after the reset has been seen
+} inaAccumulator;          // of structure
+/*! typedef contains the decimated output of a device filter, see "setFilter()" */
+typedef struct {
+  inaReading average;           ///< Window average or EMA value of each measurement
+  uint16_t   minBusMilliVolts;  ///< Lowest bus voltage in the window
+  uint16_t   maxBusMilliVolts;  ///< Highest bus voltage in the window
+  int32_t    minBusMicroAmps;   ///< Lowest current in the window
+  int32_t    maxBusMicroAmps;   ///< Highest current in the window
+  int32_t    rmsBusMicroAmps;   ///< RMS current over the window, or its EMA equivalent
+} inaFilterReading;             // of structure
+/*! typedef contains the running state of a device filter, see "setFilter()" */
+typedef struct {
+  uint8_t          mode;           ///< ina_Filter mode
+  uint8_t          shift;          ///< log2 of the window length
+  uint8_t          count;          ///< Samples seen in the current window
+  bool             outputNew;      ///< Set when "output" has not been retrieved yet
+  int64_t          sumMicroWatts;  ///< Sum (average) or scaled EMA of the power
+  int64_t          sumMicroAmps;   ///< Sum (average) or scaled EMA of the current
+  int64_t          sumShunt;       ///< Sum (average) or scaled EMA of the shunt voltage
+  uint32_t         sumMilliVolts;  ///< Sum (average) or scaled EMA of the bus voltage
+  uint64_t         meanSquare;     ///< Running mean of the squared current
+  bool             started;        ///< Set once the EMA has been seeded with the first sample
+  inaFilterReading window;         ///< Extremes of the window being collected
+  inaFilterReading output;         ///< Last published result
+} inaFilter;                       // of structure
+/*! typedef contains the auto-ranging state of a device, see "setAutoRange()" */
+typedef struct {
+  uint32_t peak;        ///< Largest raw shunt reading of the window being collected
+  int32_t  shuntOver;   ///< SOVL in microvolts, written again in each range, INT32_MAX when off
+  int32_t  shuntUnder;  ///< SUVL in microvolts, written again in each range, INT32_MIN when off
+  uint16_t config;      ///< Shadow copy of the CONFIG register, so a switch needs no reads
+  uint8_t  count;       ///< Samples seen in the window being collected
+  bool     enabled;     ///< Set when the device is auto-ranged
+  bool     fine;        ///< Set while the finer shunt range is in use
+} inaRange;             // of structure
+/*! typedef contains the library traffic counters, only counted when INA_COUNTERS is set */
+typedef struct {
+  uint32_t i2cTransactions;  ///< I2C transmissions and requests made
+  uint32_t i2cBytes;         ///< Bytes written and read, excluding the device addresses
+  uint32_t delayMicros;      ///< Microseconds spent in the I2C delay, see setI2CSpeed()
+  uint32_t eepromReads;      ///< Device records read from EEPROM or device storage
+  uint32_t cacheHits;        ///< Device loads served without reading the record
+} inaCounters;               // of structure
+/*! Alert callback, called from "dispatchAlerts()" with the device and its INA_ALERT_CAUSE bits */
+typedef void (*inaAlertCallback)(const uint8_t deviceNumber, const uint8_t cause);
+/*! typedef contains the alert dispatch state of a device, see "onAlert()" */
+typedef struct {
+  inaAlertCallback callback;    ///< Function called when the device alerts, may be nullptr
+  uint16_t         function;    ///< Limit function the user armed while the re-arm limit is active
+  uint16_t         limit;       ///< Limit register value the user armed
+  uint8_t          percent;     ///< Hysteresis in percent of the limit, 0 for none
+  uint8_t          cause;       ///< Causes latched since the last "clearAlert()"
+  bool             rearming;    ///< Set while waiting for the reading to come back past hysteresis
+  bool             registered;  ///< Set by "onAlert()", only these devices are read for alerts
+} inaAlert;                     // of structure
 /*! Enumerated list detailing the names of all supported INA devices. The INA3221 is stored
     as 3 distinct devices each with their own enumerated type. */
 enum ina_Type {
@@ -209,6 +371,12 @@ enum ina_Mode {
   INA_MODE_CONTINUOUS_BUS,    ///< Continuous bus, no shunt
   INA_MODE_CONTINUOUS_BOTH    ///< Both continuous, default value
 };                            // of enumerated type
+/*! Enumerated list detailing the streaming filters, see "setFilter()" */
+enum ina_Filter {
+  INA_FILTER_NONE,     ///< No filtering, the filter state is freed
+  INA_FILTER_AVERAGE,  ///< Average of each window of samples, one output per window
+  INA_FILTER_EMA       ///< Exponential moving average, output once per window
+};                     // of enumerated type
 /************************************************************************************************
 ** Declare constants used in the class                                                         **
 ************************************************************************************************/
@@ -260,12 +428,25 @@ const uint16_t INA226_CONFIG_SADC_MASK{0x0038};     ///< INA226 Bits 3-4
 const uint8_t  INA228_DIE_ID_REGISTER{0x3F};        ///< INA228 Device_ID  Register
 const uint16_t INA228_DIE_ID_VALUE{0x2280};         ///< INA228 Hard-coded Die ID for INA228
 const uint8_t  INA228_BUS_VOLTAGE_REGISTER{0x5};    ///< INA228 Bus Voltage Register
-const uint16_t INA228_BUS_VOLTAGE_LSB{195};           ///< INA228 LSB in uV *100 1953125uV, extra code
 const uint8_t  INA228_SHUNT_VOLTAGE_REGISTER{4};    ///< INA228 Shunt Voltage Register
-const uint8_t  xINA228_CURRENT_REGISTER{4};          ///< INA228 Current Register
-const uint16_t xINA228_CONFIG_AVG_MASK{0x0E00};      ///< INA228 Bits 9-11
-const uint16_t xINA228_CONFIG_BADC_MASK{0x01C0};     ///< INA228 Bits 6-8 masked
-const uint16_t xINA228_CONFIG_SADC_MASK{0x0038};     ///< INA228 Bits 3-4
+const uint8_t  INA228_ADC_CONFIG_REGISTER{0x01};    ///< INA228 ADC Configuration Register
+const uint8_t  INA228_CURRENT_REGISTER{0x07};       ///< INA228 Current Register, 20 bits
+const uint8_t  INA228_POWER_REGISTER{0x08};         ///< INA228 Power Register, 24 bits
+const uint8_t  INA228_DIAG_ALERT_REGISTER{0x0B};    ///< INA228 Diagnostic and Alert Register
+const uint8_t  INA228_ADCRANGE_BIT{4};              ///< INA228 Configuration ADCRANGE bit
+const uint32_t INA228_ADCRANGE_LIMIT{40960};        ///< INA228 Max shunt uV with ADCRANGE set
+const uint16_t INA228_CONV_READY_MASK{0x0002};      ///< INA228 CNVRF bit in DIAG_ALRT
+const uint8_t  INA228_ALERT_CONV_RDY_BIT{14};       ///< INA228 CNVR bit in DIAG_ALRT
+const uint16_t INA228_ADC_MODE_MASK{0xF000};        ///< INA228 ADC_CONFIG Bits 12-15
+const uint16_t INA228_ADC_BUS_MASK{0x0E00};         ///< INA228 ADC_CONFIG Bits 9-11
+const uint16_t INA228_ADC_SHUNT_MASK{0x01C0};       ///< INA228 ADC_CONFIG Bits 6-8
+const uint16_t INA228_ADC_AVG_MASK{0x0007};         ///< INA228 ADC_CONFIG Bits 0-2
+const uint8_t  INA228_SHUNT_CAL_REGISTER{0x02};     ///< INA228 Shunt Calibration Register
+const uint8_t  INA228_ENERGY_REGISTER{0x09};        ///< INA228 Energy Register, 40 bits
+const uint8_t  INA228_CHARGE_REGISTER{0x0A};        ///< INA228 Charge Register, 40 bits signed
+const uint16_t INA228_RESET_ACCUMULATORS{0x4000};   ///< INA228 RSTACC bit in configuration
+const uint32_t INA228_CURRENT_STEPS{524288};        ///< INA228 2^19, maximum current over LSB
+const int64_t  INA_INTEGRATOR_CARRY{1LL << 40};     ///< Fraction carried into whole units above
 
 const uint8_t  INA260_SHUNT_VOLTAGE_REGISTER{0};    ///< INA260 Register doesn't exist
 const uint8_t  INA260_CURRENT_REGISTER{1};          ///< INA260 Current Register
@@ -278,7 +459,162 @@ const uint16_t INA3221_SHUNT_VOLTAGE_LSB{400};      ///< INA3221 LSB in uV *10
 const uint16_t INA3221_CONFIG_BADC_MASK{0x01C0};    ///< INA3221 Bits 7-10  masked
 const uint8_t  INA3221_MASK_REGISTER{0xF};          ///< INA32219 Mask register
 const uint8_t  I2C_DELAY{10};                       ///< Microsecond delay on I2C writes
+const uint8_t  INA_I2C_ADDRESS_NACK{2};             ///< Wire status of an address NACK
+const uint8_t  INA_I2C_DATA_NACK{3};                ///< Wire status of a data NACK
+const uint8_t  INA_EEPROM_SIGNATURE{0xA5};          ///< Marks valid device records in EEPROM
+const uint8_t  INA_MAX_BUSES{4};                    ///< Maximum number of I2C buses, see addBus()
+const uint8_t  INA_MUX_DEFAULT_ADDRESS{0x70};       ///< Default TCA9548A multiplexer address
+const uint8_t  INA_MUX_CHANNELS{8};                 ///< Channels on a TCA9548A multiplexer
+const uint8_t  INA_FILTER_MAX_WINDOW{128};          ///< Longest filter window, see setFilter()
+const uint8_t  INA_AUTORANGE_WINDOW{16};            ///< Quiet samples before a finer range is used
+const uint8_t  INA_LATENCY_BUCKETS{8};              ///< Transfer time classes, see getStatistics()
+const uint8_t  INA_ALERT_RESPONSE_ADDRESS{0x0C};    ///< SMBus Alert Response Address
+const uint8_t  INA_MAX_CHIP_REGISTERS{6};           ///< Most registers read from one device
+const uint8_t  INA_STREAM_VERSION{1};               ///< Format of the INA_SampleEncoder stream
+const uint16_t INA_ALERT_FUNCTION_MASK{0xF800};     ///< Limit function bits 11-15 in mask/enable
+const uint16_t INA_ALERT_FUNCTION_FLAG{0x0010};     ///< AFF bit, a limit function has alerted
+const uint16_t INA_ALERT_OVERFLOW_FLAG{0x0004};     ///< OVF bit, math overflow
+const uint8_t  INA_ALERT_LATCH_BIT{0};              ///< LEN bit, ALERT held until mask/enable read
+const uint16_t INA_CONVERSION_READY_FLAG{0x0008};   ///< CVRF bit in mask/enable
+const uint8_t  INA228_ALERT_LATCH_BIT{15};          ///< INA228 ALATCH bit in DIAG_ALRT
+const uint8_t  INA228_SHUNT_OVER_REGISTER{0x0C};    ///< INA228 SOVL shunt over-voltage limit
+const uint8_t  INA228_SHUNT_UNDER_REGISTER{0x0D};   ///< INA228 SUVL shunt under-voltage limit
+const uint8_t  INA228_BUS_OVER_REGISTER{0x0E};      ///< INA228 BOVL bus over-voltage limit
+const uint8_t  INA228_BUS_UNDER_REGISTER{0x0F};     ///< INA228 BUVL bus under-voltage limit
+const uint8_t  INA228_POWER_LIMIT_REGISTER{0x11};   ///< INA228 PWR_LIMIT power over limit
+const uint16_t INA228_MATH_OVERFLOW_FLAG{0x0200};   ///< INA228 MATHOF bit in DIAG_ALRT
+const uint8_t  INA_ALERT_CAUSE_SHUNT_OVER{0x01};    ///< Alert cause, shunt over-voltage
+const uint8_t  INA_ALERT_CAUSE_SHUNT_UNDER{0x02};   ///< Alert cause, shunt under-voltage
+const uint8_t  INA_ALERT_CAUSE_BUS_OVER{0x04};      ///< Alert cause, bus over-voltage
+const uint8_t  INA_ALERT_CAUSE_BUS_UNDER{0x08};     ///< Alert cause, bus under-voltage
+const uint8_t  INA_ALERT_CAUSE_POWER_OVER{0x10};    ///< Alert cause, power over limit
+const uint8_t  INA_ALERT_CAUSE_CONVERSION{0x20};    ///< Alert cause, conversion ready
+const uint8_t  INA_ALERT_CAUSE_OVERFLOW{0x40};      ///< Alert cause, math overflow
+const uint8_t  INA_ALERT_CAUSE_REARMED{0x80};       ///< Set with the cause when a limit is re-armed
+const uint16_t INA_TIMING_UNITY{1024};              ///< Timing scale of a device at nominal speed
+const uint16_t INA_TIMING_DEFAULT{1152};            ///< Uncalibrated timing scale, nominal + 12.5%
+const uint8_t  INA_TIMING_MARGIN{3};                ///< Percent added by calibrateTiming()
+#if defined(ESP32)
+const uint16_t INA_TASK_STACK_SIZE{4096};           ///< Stack of the ESP32 sampling task
+const uint8_t  INA_TASK_PRIORITY{5};                ///< Priority of the ESP32 sampling task
+const uint8_t  INA_TASK_CORE{0};                    ///< Core of the sampling task, loop() is on 1
+#endif
+#if defined(IRAM_ATTR)                             // ESP32/ESP8266, interrupt code must be in IRAM
+  #define INA_ISR_ATTR IRAM_ATTR                    ///< Places the interrupt path in IRAM
+#else
+  #define INA_ISR_ATTR                              ///< No placement needed
+#endif
+#if defined(__AVR__)                                // Single core, only the compiler may reorder
+  #define INA_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")  ///< Compiler barrier
+#else
+  #define INA_MEMORY_BARRIER() __sync_synchronize()  ///< Full memory barrier on multi-core
+#endif
 // clang-format on
+/*! typedef contains the register transfer queued by the asynchronous engine, see "setAsync()" */
+typedef struct {
+  uint8_t  deviceNumber;                       ///< Device being read, UINT8_MAX when idle
+  uint8_t  count;                              ///< Number of registers queued
+  uint8_t  next;                               ///< Next register to transfer
+  uint8_t  width;                              ///< Register width in bytes, 2 or 3
+  bool     failed;                             ///< Set if a register of the device couldn't be read
+  uint32_t tick;                               ///< micros() value when the device was found ready
+  uint8_t  registers[INA_MAX_CHIP_REGISTERS];  ///< Register addresses, in transfer order
+  uint32_t values[INA_MAX_CHIP_REGISTERS];     ///< Register contents as they are transferred
+} inaTransferQueue;                            // of structure
+/*! typedef contains the acquisition and I2C health statistics of a device, see "getStatistics()" */
+typedef struct {
+  uint32_t samples;                         ///< Samples stored by the acquisition engine
+  uint32_t firstTick;                       ///< micros() value of the first sample since reset
+  uint32_t lastTick;                        ///< micros() value of the latest sample
+  uint32_t overruns;                        ///< Estimated conversions overwritten unread
+  uint32_t transfers;                       ///< I2C transfers made to the device
+  uint32_t nacks;                           ///< Transfers not acknowledged or cut short
+  uint32_t retries;                         ///< Failed transfers repeated, see setI2CRetries()
+  uint32_t dropped;                         ///< Samples dropped as their registers couldn't be read
+  uint32_t maxMicros;                       ///< Longest transfer
+  uint64_t sumMicros;                       ///< Total time of all transfers
+  uint32_t histogram[INA_LATENCY_BUCKETS];  ///< Transfers by duration, see "getStatistics()"
+  uint32_t sampleMilliHertz;                ///< Sample rate, computed by "getStatistics()"
+  uint32_t averageMicros;                   ///< Transfer average, see "getStatistics()"
+} inaStatistics;                            // of structure
+
+class INA_Transport {
+  /*!
+   * @class   INA_Transport
+   * @brief   I2C bus interface the library talks to the devices through
+   * @details The methods are the subset of the Arduino "TwoWire" interface the library uses, so
+   *          "INA_WireTransport" simply forwards them. Any other implementation, such as the
+   *          "INA_Simulator" register model, can be set with "addBus()" or "setTransport()" to run
+   *          the library without the I2C hardware. As with "TwoWire", "endTransmission()" returns 0
+   *          when the device acknowledged, "requestFrom()" the number of bytes received and
+   *          "read()" -1 once no more bytes are left
+   */
+ public:
+  virtual void    begin() {}
+  virtual void    setClock(const uint32_t clock) { (void)clock; }
+  virtual void    beginTransmission(const uint8_t address) = 0;
+  virtual uint8_t write(const uint8_t data) = 0;
+  virtual uint8_t endTransmission(const bool sendStop = true) = 0;
+  virtual uint8_t requestFrom(const uint8_t address, const uint8_t count) = 0;
+  virtual int     read() = 0;
+};  // of INA_Transport definition
+class INA_WireTransport : public INA_Transport {
+  /*!
+   * @class   INA_WireTransport
+   * @brief   Default transport, forwards every call to a "TwoWire" bus such as "Wire"
+   */
+ public:
+  explicit INA_WireTransport(TwoWire* bus = nullptr) : _bus(bus) {}  ///< Attach a bus
+  TwoWire* bus() const { return (_bus); }                             ///< Attached bus
+  void     begin() override;
+  void     setClock(const uint32_t clock) override;
+  void     beginTransmission(const uint8_t address) override;
+  uint8_t  write(const uint8_t data) override;
+  uint8_t  endTransmission(const bool sendStop = true) override;
+  uint8_t  requestFrom(const uint8_t address, const uint8_t count) override;
+  int      read() override;
+ private:
+  TwoWire* _bus;  ///< Bus the calls are forwarded to
+};  // of INA_WireTransport definition
+
+class INA_SampleBuffer {
+  /*!
+   * @class   INA_SampleBuffer
+   * @brief   Lock-free single-producer/single-consumer queue of raw samples
+   * @details The producer (the acquisition engine in "poll()" or an interrupt handler) only ever
+   *          changes the head index and the consumer only ever changes the tail index, so neither
+   *          side needs to disable interrupts. The storage is provided by the "INA_RingBuffer"
+   *          template, which sets the capacity at compile time. When the buffer is full new samples
+   *          are dropped and counted rather than overwriting samples the consumer hasn't seen
+   */
+ public:
+  bool     push(const inaRawSample& sample);
+  bool     pop(inaRawSample& sample);
+  uint8_t  popBatch(inaRawSample samples[], const uint8_t maxSamples);
+  uint8_t  available() const;
+  uint16_t dropped() const;
+ protected:
+  INA_SampleBuffer(inaRawSample* storage, const uint8_t mask);
+ private:
+  inaRawSample*     _storage;     ///< Pointer to the sample storage array
+  const uint8_t     _mask;        ///< Capacity - 1, capacity is a power of 2
+  volatile uint8_t  _head{0};     ///< Free-running write index, only changed by the producer
+  volatile uint8_t  _tail{0};     ///< Free-running read index, only changed by the consumer
+  volatile uint16_t _dropped{0};  ///< Samples dropped because the buffer was full
+};  // of INA_SampleBuffer definition
+template <uint8_t CAPACITY>
+class INA_RingBuffer : public INA_SampleBuffer {
+  /*!
+   * @class   INA_RingBuffer
+   * @brief   Sample ring buffer holding CAPACITY raw samples, CAPACITY being a power of 2 <= 128
+   */
+  static_assert(CAPACITY != 0 && (CAPACITY & (CAPACITY - 1)) == 0 && CAPACITY <= 128,
+                "INA_RingBuffer capacity must be a power of 2 no larger than 128");
+ public:
+  INA_RingBuffer() : INA_SampleBuffer(_buffer, CAPACITY - 1) {}  ///< Pass storage to base class
+ private:
+  inaRawSample _buffer[CAPACITY];  ///< Sample storage
+};  // of INA_RingBuffer definition
 
 class INA_Class {
   /*!
@@ -286,11 +622,17 @@ class INA_Class {
    * @brief   Forward definitions for the INA_Class
    */
  public:
-  INA_Class(uint8_t expectedDevices = 0);
+  INA_Class(uint8_t expectedDevices = 0, const bool cacheDevices = false);
   ~INA_Class();
   uint8_t     begin(const uint16_t maxBusAmps, const uint32_t microOhmR,
                     const uint8_t deviceNumber = UINT8_MAX);
-  void        setI2CSpeed(const uint32_t i2cSpeed = INA_I2C_STANDARD_MODE) const;
+  uint8_t     resume();
+  uint8_t     addBus(TwoWire& bus);
+  uint8_t     addBus(INA_Transport& transport);
+  bool        setTransport(INA_Transport& transport, const uint8_t bus = 0);
+  bool        addMux(const uint8_t muxAddress = INA_MUX_DEFAULT_ADDRESS, const uint8_t bus = 0);
+  void        setI2CSpeed(const uint32_t i2cSpeed = INA_I2C_STANDARD_MODE,
+                          const uint8_t i2cDelay = UINT8_MAX, const uint8_t bus = UINT8_MAX);
   void        setMode(const uint8_t mode, const uint8_t deviceNumber = UINT8_MAX);
   void        setAveraging(const uint16_t averages, const uint8_t deviceNumber = UINT8_MAX);
   void        setBusConversion(const uint32_t convTime, const uint8_t deviceNumber = UINT8_MAX);
@@ -301,11 +643,41 @@ class INA_Class {
   int32_t     getShuntRaw(const uint8_t deviceNumber = 0);
   int32_t     getBusMicroAmps(const uint8_t deviceNumber = 0);
   int64_t     getBusMicroWatts(const uint8_t deviceNumber = 0);
+  uint8_t     readAll(inaReading readings[], const uint8_t arraySize);
+  void        triggerAll();
+  uint8_t     collectAll(inaReading readings[], const uint8_t arraySize);
+  void        syncRegisters(const uint8_t deviceNumber = UINT8_MAX);
   const char* getDeviceName(const uint8_t deviceNumber = 0);
   uint8_t     getDeviceAddress(const uint8_t deviceNumber = 0);
+  uint8_t     getDeviceBus(const uint8_t deviceNumber = 0);
+  bool        getDeviceInfo(const uint8_t deviceNumber, inaDeviceInfo& info);
+  void        getCounters(inaCounters& counters) const;
+  void        resetCounters();
+  void        setStatistics(const bool enabled);
+  bool        getStatistics(const uint8_t deviceNumber, inaStatistics& statistics) const;
+  void        resetStatistics(const uint8_t deviceNumber = UINT8_MAX);
+  void        setI2CRetries(const uint8_t retries);
+  bool        readFailed();
   void        reset(const uint8_t deviceNumber = 0);
   bool        conversionFinished(const uint8_t deviceNumber = 0);
   void        waitForConversion(const uint8_t deviceNumber = UINT8_MAX);
+  void        startAcquisition(const bool alertDriven = false);
+  void        startAcquisition(INA_SampleBuffer& buffer, const bool alertDriven = false);
+  void        stopAcquisition();
+  uint8_t     poll();
+  void        setAsync(const bool async);
+  void        setSamplePeriod(const uint32_t periodMicros);
+  void        setTimedReads(const bool timed);
+  uint8_t     calibrateTiming(const uint8_t deviceNumber = UINT8_MAX,
+                              const uint8_t marginPercent = INA_TIMING_MARGIN);
+  void        setDeferredCommit(const bool deferred);
+  void        commit();
+  uint32_t    nextDueMicros() const;
+  void        alertInterrupt();
+  bool        getSample(const uint8_t deviceNumber, inaReading& reading);
+  void        convertSample(const inaRawSample& sample, inaReading& reading);
+  void        convertSamples(const inaRawSample samples[], inaReading readings[],
+                             const uint8_t count) const;
   bool        alertOnConversion(const bool alertState, const uint8_t deviceNumber = UINT8_MAX);
   bool        alertOnShuntOverVoltage(const bool alertState, const int32_t milliVolts,
                                       const uint8_t deviceNumber = UINT8_MAX);
@@ -317,27 +689,237 @@ class INA_Class {
                                      const uint8_t deviceNumber = UINT8_MAX);
   bool        alertOnPowerOverLimit(const bool alertState, const int32_t milliAmps,
                                     const uint8_t deviceNumber = UINT8_MAX);
+  bool        onAlert(inaAlertCallback callback, const uint8_t deviceNumber = UINT8_MAX);
+  void        setAlertHysteresis(const uint8_t percent, const uint8_t deviceNumber = UINT8_MAX);
+  void        setAlertResponse(const bool useAlertResponse);
+  uint8_t     dispatchAlerts();
+  uint8_t     getAlertCause(const uint8_t deviceNumber = 0) const;
+  void        clearAlert(const uint8_t deviceNumber = UINT8_MAX);
+  void        resetEnergy(const uint8_t deviceNumber = UINT8_MAX);
+  int64_t     getEnergyMicroJoules(const uint8_t deviceNumber = 0);
+  int64_t     getChargeMicroCoulombs(const uint8_t deviceNumber = 0);
+  void        setFilter(const uint8_t mode, const uint8_t window = 16,
+                        const uint8_t deviceNumber = UINT8_MAX);
+  bool        getFiltered(const uint8_t deviceNumber, inaFilterReading& reading);
+  bool        setAutoRange(const bool enabled, const uint8_t deviceNumber = UINT8_MAX);
+  #if defined(ESP32)
+  bool startTask(INA_SampleBuffer& buffer, const uint8_t alertPin = UINT8_MAX,
+                 const uint8_t core = INA_TASK_CORE, const uint8_t priority = INA_TASK_PRIORITY);
+  void stopTask();
+  bool lock(const uint32_t waitMillis = UINT32_MAX);
+  void unlock();
+  #endif
   uint16_t    _EEPROM_offset = 0;  ///< Offset to all EEPROM addresses, GitHub issue #41
   #if defined(ESP32) || defined(ESP8266)
   uint16_t _EEPROM_size = 512;  ///< Default EEPROM reserved space for ESP32 and ESP8266
   #endif
  private:
-  int16_t    readWord(const uint8_t addr, const uint8_t deviceAddress) const;
-  int32_t    read3Bytes(const uint8_t addr, const uint8_t deviceAddress) const;
-  void       writeWord(const uint8_t addr, const uint16_t data, const uint8_t deviceAddress) const;
-  void       readInafromEEPROM(const uint8_t deviceNumber);
-  void       writeInatoEEPROM(const uint8_t deviceNumber);
-  void       initDevice(const uint8_t deviceNumber);
-  uint8_t    _DeviceCount{0};         ///< Total number of devices detected
-  uint8_t    _currentINA{UINT8_MAX};  ///< Stores current INA device number
-  uint8_t    _expectedDevices{0};     ///< If 0 use EEPROM, otherwise use RAM for INA structures
-  inaEEPROM* _DeviceArray;            ///< Pointer to dynamic array of devices if not using EEPROM
-  inaEEPROM  inaEE;                   ///< INA device structure
-  inaDet     ina;                     ///< INA device structure
+  INA_Transport& wire() const;
+  uint8_t        busDelay() const;
+  inaState*      pointerState(const uint8_t deviceAddress) const;
+  bool           setPointer(const uint8_t addr, const uint8_t deviceAddress) const;
+  uint32_t       transferStart() const;
+  bool           retryTransfer(const uint8_t deviceAddress, const bool success,
+                               const uint32_t startMicros, uint8_t& attempt) const;
+  uint8_t        readError() const;
+  int16_t        readWord(const uint8_t addr, const uint8_t deviceAddress) const;
+  int32_t        read3Bytes(const uint8_t addr, const uint8_t deviceAddress) const;
+  uint64_t       read5Bytes(const uint8_t addr, const uint8_t deviceAddress) const;
+  bool           readRegisters(const uint8_t registers[], const uint8_t count, const uint8_t width,
+                               uint32_t buffer[], const uint8_t deviceAddress) const;
+  void           writeWord(const uint8_t addr, const uint16_t data,
+                           const uint8_t deviceAddress) const;
+  uint32_t       readBusRegister() const;
+  int32_t        readShuntRegister() const;
+  int32_t        readCurrentRegister() const;
+  uint32_t       readPowerRegister() const;
+  uint8_t        configAddress() const;
+  uint8_t        maskAddress() const;
+  uint8_t        ina228ConversionCode(const uint32_t convTime) const;
+  uint32_t       conversionMicros(const uint16_t configRegister) const;
+  void           scheduleNext(inaState& state, const uint32_t tick) const;
+  uint32_t       predictedMicros(const inaState& state) const;
+  bool           resultReady();
+  void           triggerConversion() const;
+  uint16_t       getConfiguration() const;
+  uint16_t       modeConfiguration(const uint16_t configRegister, const uint8_t mode) const;
+  void           setConfiguration(const uint16_t configRegister);
+  uint16_t       getMaskEnable() const;
+  void           setMaskEnable(const uint16_t maskRegister);
+  inaState*      currentState() const;
+  bool           conversionReady();
+  bool           hasAlertPin(const uint8_t type) const;
+  uint8_t        chipRegisters(const uint8_t deviceNumber, uint8_t registers[],
+                               uint8_t& width) const;
+  uint8_t        unpackChip(const uint8_t deviceNumber, const uint32_t values[],
+                            const uint8_t count, const uint32_t tick,
+                            inaRawSample samples[]) const;
+  uint8_t        readChip(const uint8_t deviceNumber, inaRawSample samples[]) const;
+  bool           deviceDue(const inaState& state, const uint32_t now, const bool alerted) const;
+  void           storeSamples(const uint8_t deviceNumber, const uint8_t channels);
+  void           recordSamples(const uint8_t deviceNumber, const uint8_t channels);
+  uint8_t        pollAsync();
+  bool           triggeredMode() const;
+  bool           dutyCycled() const;
+  void           wakeDevice(const uint8_t deviceNumber);
+  void           readDevices(inaReading readings[], const uint8_t devices);
+  void           armDevices(const uint8_t devices);
+  uint16_t       busToMilliVolts(const uint32_t raw) const;
+  int32_t        shuntToMicroVolts(const int32_t raw) const;
+  int32_t        currentToMicroAmps(const int32_t raw) const;
+  int64_t        powerToMicroWatts(const uint32_t raw) const;
+  void           computeScales(const uint8_t deviceNumber);
+  inaScale       makeScale(const uint32_t numerator, const uint32_t denominator,
+                           const uint8_t rawBits) const;
+  int32_t        applyScale(const int32_t raw, const inaScale& scale) const;
+  int64_t        applyWideScale(const int32_t raw, const inaScale& scale) const;
+  void           integrate(const inaRawSample& sample);
+  void           carryFraction(int64_t& whole, int64_t& fraction) const;
+  void           filterSample(const inaRawSample& sample);
+  void           publishFilter(inaFilter& filter) const;
+  uint16_t       ina228Calibration() const;
+  uint16_t       calibrationValue() const;
+  bool           calibrated();
+  void           applyRange(const uint8_t deviceNumber, const bool fine);
+  void           autoRange(const uint8_t deviceNumber);
+  int32_t        rangedShunt(const uint8_t deviceNumber, const int32_t raw) const;
+  uint32_t       squareRoot(uint64_t value) const;
+  bool           checkAlert(const uint8_t deviceNumber);
+  bool           decodeAlert(const uint8_t deviceNumber, const uint16_t flags);
+  uint8_t        limitCause(const uint16_t flags, const uint8_t topBit) const;
+  void           writeLimit(const uint8_t limitRegister, const int64_t value, const int32_t lowest,
+                            const int32_t highest) const;
+  void           writeShuntLimit(const uint8_t deviceNumber, const bool over,
+                                 const int64_t microVolts);
+  void           rearmAlert(inaAlert& alert, const uint8_t cause);
+  uint8_t        alertResponse(const uint8_t bus) const;
+  void           fitStorage();
+  bool           setupState();
+  void           setupDevices();
+  void           commitEEPROM();
+  void           writeHeader();
+  void           readInafromEEPROM(const uint8_t deviceNumber);
+  void           writeInatoEEPROM(const uint8_t deviceNumber);
+  void           storeRecord(const uint8_t deviceNumber);
+  bool           sameRecord(const inaEEPROM& stored, const inaEEPROM& record) const;
+  void           initDevice(const uint8_t deviceNumber);
+  uint8_t           _DeviceCount{0};             ///< Total number of devices detected
+  uint8_t           _currentINA{UINT8_MAX};      ///< Stores current INA device number
+  uint8_t           _expectedDevices{0};         ///< If 0 use EEPROM, else RAM for INA structures
+  bool              _cacheDevices{false};        ///< If set keep decoded inaDet structures in RAM
+  bool              _deferCommit{false};         ///< Set while several records are written
+  bool              _commitOnWrite{true};        ///< Cleared by setDeferredCommit()
+  bool              _commitPending{false};       ///< EEPROM changed but not committed yet
+  INA_Transport*    _Bus[INA_MAX_BUSES];         ///< I2C buses searched, bus 0 is "Wire"
+  INA_WireTransport _WireBus[INA_MAX_BUSES];     ///< Adapters of the buses added as "TwoWire"
+  uint8_t           _BusCount{1};                ///< Number of I2C buses in use
+  uint8_t*          _PollOrder{nullptr};         ///< Device order interleaving the buses
+  uint8_t           _MuxAddress[INA_MAX_BUSES];  ///< Multiplexer address per bus, 0 if none
+  uint8_t           _i2cDelay[INA_MAX_BUSES];    ///< Microseconds to wait after writes, per bus
+  mutable uint8_t   _MuxChannel[INA_MAX_BUSES];  ///< Multiplexer channel currently selected
+  inaEEPROM*        _DeviceArray;                ///< Dynamic array of devices if not using EEPROM
+  inaDet*           _DeviceCache{nullptr};       ///< Decoded device array when caching is on
+  inaState*         _DeviceState{nullptr};       ///< Runtime state, see setupState()
+  inaRawSample*     _Samples{nullptr};           ///< Latest sample per device from poll()
+  INA_SampleBuffer* _SampleBuffer{nullptr};      ///< Optional queue every new sample is pushed to
+  inaAccumulator*   _Accumulators{nullptr};      ///< Software integrators, see resetEnergy()
+  inaFilter*        _Filters{nullptr};           ///< Streaming filters, see setFilter()
+  inaRange*         _Ranges{nullptr};            ///< Auto-ranging state, see setAutoRange()
+  inaStatistics*    _Statistics{nullptr};        ///< Health statistics, see setStatistics()
+  uint8_t           _i2cRetries{0};              ///< Failed transfer repeats, setI2CRetries()
+  mutable bool      _readError{false};           ///< Set by a failed read, see readFailed()
+  bool              _acquiring{false};           ///< Set while the acquisition engine is running
+  bool              _async{false};               ///< Spread the register reads over poll() calls
+  bool              _asyncAlerted{false};        ///< Alert flag taken for the current async round
+  uint8_t           _asyncNext{0};               ///< Next poll order position to check
+  uint32_t          _samplePeriod{0};            ///< Duty cycle period, see setSamplePeriod()
+  uint32_t          _dutyPeriod{0};              ///< Period in use by the engine, 0 if not cycling
+  uint32_t          _dutyTick{0};                ///< micros() value of the next duty cycle wake-up
+  bool              _timedReads{false};          ///< Read at predicted completion, no flag polls
+  inaTransferQueue* _Queue{nullptr};             ///< Register transfers, see setAsync()
+  uint32_t          _BatchStart{0};              ///< Time the last batch of conversions started
+  uint32_t          _BatchMicros{0};             ///< Longest conversion of the batch, 0 if none
+  bool              _alertDriven{false};         ///< Only check alert-pin devices after an alert
+  volatile bool     _alertPending{false};        ///< Set by alertInterrupt(), cleared by poll()
+  volatile bool     _alertDispatch{false};       ///< Set by alertInterrupt(), see dispatchAlerts()
+  bool              _alertResponse{false};       ///< Identify devices with the SMBus ARA
+  inaAlert*         _Alerts{nullptr};            ///< Alert dispatch state, see onAlert()
+  #if INA_COUNTERS
+  mutable inaCounters _Counters{};  ///< Traffic counters, see getCounters()
+  #endif
+  inaEEPROM         inaEE;                       ///< INA device structure
+  inaDet            ina;                         ///< INA device structure
+  #if defined(ESP32)
+  static void       taskLoop(void* parameter);
+  static void       taskAlert(void* parameter);
+  TaskHandle_t      _Task{nullptr};        ///< Sampling task, see startTask()
+  SemaphoreHandle_t _Mutex{nullptr};       ///< Recursive lock, see lock()
+  uint8_t           _alertPin{UINT8_MAX};  ///< Pin the sampling task is woken by
+  #endif
   #if defined(__AVR__) || defined(CORE_TEENSY) || defined(ESP32) || defined(ESP8266) || \
       defined(__STM32F1__)
   #else
-  inaEEPROM _EEPROMEmulation[32];  ///< Actual array of up to 32 devices
+  inaEEPROM* _EEPROMEmulation{nullptr};  ///< Device array, grows as devices are found
+  uint16_t   _EmulationSize{0};          ///< Number of elements allocated in the device array
   #endif
 };  // of INA_Class definition
+class INA_SampleEncoder {
+  /*!
+   * @class   INA_SampleEncoder
+   * @brief   Writes raw samples as a compact binary stream to a serial port, SD card file or any
+   *          other "Print" destination
+   * @details The stream starts with a header written by "writeHeader()" which holds the
+   *          calibration of each device, followed by one record per sample written by "encode()".
+   *          The values of a record are the differences to the previous record of the same device,
+   *          written as variable length integers, so that a sample usually takes 6 to 9 bytes
+   *          instead of the 40 or more of a line of text. The storage for the previous values is
+   *          provided by the "INA_StreamEncoder" template. A host decodes the stream as follows,
+   *          all fixed size values being little-endian:\n\n
+   *          Header: the bytes 'I', 'N', 'A', INA_STREAM_VERSION and the number of devices N,
+   *          then N device blocks of 33 bytes: type (uint8_t, see "ina_Type"), I2C address
+   *          (uint8_t), busVoltage_LSB and shuntVoltage_LSB (uint16_t), current_LSB, power_LSB
+   *          and microOhmR (uint32_t), followed by the bus, shunt and current scale factors as a
+   *          uint32_t multiplier and a uint8_t shift each.\n\n
+   *          Record: the device number as a varint, the micros() tick as a varint difference
+   *          (modulo 2^32) to the previous record of any device, then the raw bus, shunt and
+   *          current values as zigzag varint differences to the previous record of that device.
+   *          All previous values are 0 at the start of the stream. A varint holds 7 bits per byte,
+   *          least significant first, with bit 7 set on all but the last byte. A zigzag value z
+   *          decodes to (z >> 1) ^ -(z & 1).\n\n
+   *          Conversion: bus millivolts are (busRaw * mult) >> shift using the bus scale and 64
+   *          bit signed arithmetic, shunt microvolts and microamps likewise with their scales. The
+   *          INA260 converts its current value to both, the INA3221 its shunt value to both. Power
+   *          in microwatts is microamps * millivolts / 1000
+   */
+ public:
+  size_t writeHeader(INA_Class& ina);
+  size_t encode(const inaRawSample& sample);
+  size_t encode(const inaRawSample samples[], const uint8_t count);
+  void   reset();
+ protected:
+  INA_SampleEncoder(Print& output, inaRawSample* storage, const uint8_t devices);
+ private:
+  size_t        writeVarint(uint32_t value);
+  size_t        writeSigned(const int32_t value);
+  size_t        writeFixed(uint32_t value, const uint8_t bytes);
+  size_t        writeScale(const inaScale& scale);
+  Print&        _output;       ///< Destination of the stream
+  inaRawSample* _storage;      ///< Previous sample of each device
+  const uint8_t _devices;      ///< Number of devices the storage holds
+  uint32_t      _lastTick{0};  ///< Tick of the previous record
+};  // of INA_SampleEncoder definition
+template <uint8_t DEVICES>
+class INA_StreamEncoder : public INA_SampleEncoder {
+  /*!
+   * @class   INA_StreamEncoder
+   * @brief   Binary sample encoder for up to DEVICES devices, see "INA_SampleEncoder"
+   */
+  static_assert(DEVICES != 0, "INA_StreamEncoder needs room for at least one device");
+ public:
+  explicit INA_StreamEncoder(Print& output) : INA_SampleEncoder(output, _buffer, DEVICES) {
+    reset();
+  }  ///< Pass storage to base class
+ private:
+  inaRawSample _buffer[DEVICES];  ///< Previous sample of each device
+};  // of INA_StreamEncoder definition
 #endif
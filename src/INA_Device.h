@@ -0,0 +1,289 @@
+// clang-format off
+/*!
+ @file INA_Device.h
+
+ @brief Compile-time configured INA device driver templates
+
+ @section INA_Device_intro_section Description
+
+ The "INA_Class" in "INA.h" finds devices at runtime and dispatches on the device type for every
+ call, so the code for all supported device types is linked into every program. When the hardware
+ is known when compiling, the "INA_Device" template defined here can be used instead. The device
+ type, I2C address, maximum current and shunt resistance are template parameters, so all register
+ addresses, shifts, LSB values and calibration values are compile-time constants and only the code
+ for the device types actually instantiated ends up in flash. For example:\n\n
+
+ INA_Device<INA226, 0x40, 1, 100000> battery;  // INA226 at 0x40, +/-1A with a 0.1 Ohm shunt\n\n
+
+ Each instance only stores the "INA_Transport" it talks through and the I2C delay. The bus defaults
+ to "Wire", any other transport such as an "INA_WireTransport" on "Wire1" or an "INA_Simulator" can
+ be passed to the constructor:\n\n
+
+ INA_WireTransport bus1(&Wire1);\n
+ INA_Device<INA219, 0x41, 2, 100000> solar(bus1);  // INA219 at 0x41 on the second bus\n\n
+
+ The INA228 is not supported by the templates, "INA_Class" remains the dynamic front end for that
+ device and for devices only known at runtime. The program needs to start the bus, e.g. with
+ "Wire.begin()", before calling the "begin()" method of a device.
+
+ See "INA.h" for the license and author information.
+
+@section INA_Device_versions Changelog
+
+| Version | Date       | Developer   | Comments
+| ------- | ---------- | ----------- | --------
+| 1.2.0   | 2026-10-14 | agent       | Initial coding
+*/
+// clang-format on
+#ifndef INA__Device_h
+/*! Guard code definition to prevent multiple includes */
+#define INA__Device_h
+#include <INA.h>   // Register constants and device types
+#include <Wire.h>  // I2C Library definition
+
+/*! Device traits, only the device types specialized below are supported by "INA_Device" */
+template <uint8_t TYPE>
+struct inaTraits;
+/*! Traits of the INA219 and INA220 */
+template <>
+struct inaTraits<INA219> {
+  static constexpr uint8_t  busReg{INA_BUS_VOLTAGE_REGISTER};         ///< Bus register
+  static constexpr uint8_t  shuntReg{INA219_SHUNT_VOLTAGE_REGISTER};  ///< Shunt register
+  static constexpr uint8_t  currentReg{INA219_CURRENT_REGISTER};      ///< Current register
+  static constexpr uint8_t  busShift{3};                              ///< 3 LSB unused
+  static constexpr uint8_t  shuntShift{0};                            ///< Right-aligned
+  static constexpr uint16_t busLSB{INA219_BUS_VOLTAGE_LSB};           ///< In uV * 100
+  static constexpr uint16_t shuntLSB{INA219_SHUNT_VOLTAGE_LSB};       ///< In uV * 10
+  static constexpr uint32_t fixedLSB{0};                              ///< 0 if from maximum amps
+  static constexpr uint8_t  powerMult{20};                            ///< power = n * current LSB
+  static constexpr uint32_t calFactor{409600000};                     ///< 0 if no calibration
+  static constexpr uint8_t  readyReg{INA_BUS_VOLTAGE_REGISTER};       ///< Ready flag register
+  static constexpr uint16_t readyMask{2};                             ///< in bit 1
+  static constexpr bool     hasShunt{true};                           ///< Has a shunt register
+  static constexpr bool     hasCurrent{true};                         ///< Has current and power
+  static constexpr bool     readyClear{true};                         ///< Clear by reading power
+};  // of struct inaTraits<INA219>
+/*! Traits of the INA226, the INA230 and INA231 are identical as far as the library is concerned */
+template <>
+struct inaTraits<INA226> {
+  static constexpr uint8_t  busReg{INA_BUS_VOLTAGE_REGISTER};         ///< Bus register
+  static constexpr uint8_t  shuntReg{INA226_SHUNT_VOLTAGE_REGISTER};  ///< Shunt register
+  static constexpr uint8_t  currentReg{INA226_CURRENT_REGISTER};      ///< Current register
+  static constexpr uint8_t  busShift{0};                              ///< Right-aligned
+  static constexpr uint8_t  shuntShift{0};                            ///< Right-aligned
+  static constexpr uint16_t busLSB{INA226_BUS_VOLTAGE_LSB};           ///< In uV * 100
+  static constexpr uint16_t shuntLSB{INA226_SHUNT_VOLTAGE_LSB};       ///< In uV * 10
+  static constexpr uint32_t fixedLSB{0};                              ///< 0 if from maximum amps
+  static constexpr uint8_t  powerMult{25};                            ///< Issue #66 multiplier
+  static constexpr uint32_t calFactor{51200000};                      ///< 0 if no calibration
+  static constexpr uint8_t  readyReg{INA_MASK_ENABLE_REGISTER};       ///< Ready flag register
+  static constexpr uint16_t readyMask{8};                             ///< in bit 3
+  static constexpr bool     hasShunt{true};                           ///< Has a shunt register
+  static constexpr bool     hasCurrent{true};                         ///< Has current and power
+  static constexpr bool     readyClear{false};                        ///< Cleared by reading it
+};  // of struct inaTraits<INA226>
+/*! Traits of the INA230 */
+template <>
+struct inaTraits<INA230> : inaTraits<INA226> {};
+/*! Traits of the INA231 */
+template <>
+struct inaTraits<INA231> : inaTraits<INA226> {};
+/*! Traits of the INA260, which has an internal 2mOhm shunt and no shunt register */
+template <>
+struct inaTraits<INA260> {
+  static constexpr uint8_t  busReg{INA_BUS_VOLTAGE_REGISTER};         ///< Bus register
+  static constexpr uint8_t  shuntReg{INA260_SHUNT_VOLTAGE_REGISTER};  ///< Not present
+  static constexpr uint8_t  currentReg{INA260_CURRENT_REGISTER};      ///< Current register
+  static constexpr uint8_t  busShift{0};                              ///< Right-aligned
+  static constexpr uint8_t  shuntShift{0};                            ///< Not used
+  static constexpr uint16_t busLSB{INA260_BUS_VOLTAGE_LSB};           ///< In uV * 100
+  static constexpr uint16_t shuntLSB{0};                              ///< Not used
+  static constexpr uint32_t fixedLSB{1250000};                        ///< Fixed LSB 1.25mA in nA
+  static constexpr uint8_t  powerMult{8};                             ///< 10mW = 8 * 1.25mA
+  static constexpr uint32_t calFactor{0};                             ///< 0 if no calibration
+  static constexpr uint8_t  readyReg{INA_MASK_ENABLE_REGISTER};       ///< Ready flag register
+  static constexpr uint16_t readyMask{8};                             ///< in bit 3
+  static constexpr bool     hasShunt{false};                          ///< Has no shunt register
+  static constexpr bool     hasCurrent{true};                         ///< Has current and power
+  static constexpr bool     readyClear{false};                        ///< Cleared by reading it
+};  // of struct inaTraits<INA260>
+/*! Traits of one INA3221 channel, the channel number selects the register pair */
+template <uint8_t CHANNEL>
+struct inaTraits3221 {
+  static constexpr uint8_t  offset{2 * CHANNEL};                                ///< Channel offset
+  static constexpr uint8_t  busReg{INA_BUS_VOLTAGE_REGISTER + offset};          ///< Bus register
+  static constexpr uint8_t  shuntReg{INA3221_SHUNT_VOLTAGE_REGISTER + offset};  ///< Shunt register
+  static constexpr uint8_t  currentReg{0};                                      ///< Not present
+  static constexpr uint8_t  busShift{3};                                        ///< 3 LSB unused
+  static constexpr uint8_t  shuntShift{3};                                      ///< 3 LSB unused
+  static constexpr uint16_t busLSB{INA3221_BUS_VOLTAGE_LSB};                    ///< In uV * 100
+  static constexpr uint16_t shuntLSB{INA3221_SHUNT_VOLTAGE_LSB};                ///< In uV * 10
+  static constexpr uint32_t fixedLSB{0};                                        ///< Not used
+  static constexpr uint8_t  powerMult{0};                                       ///< Not used
+  static constexpr uint32_t calFactor{0};                                       ///< No calibration
+  static constexpr uint8_t  readyReg{INA3221_MASK_REGISTER};                    ///< Ready flag
+  static constexpr uint16_t readyMask{1};                                       ///< in bit 0
+  static constexpr bool     hasShunt{true};                                     ///< Has shunt
+  static constexpr bool     hasCurrent{false};                                  ///< From shunt
+  static constexpr bool     readyClear{false};                                  ///< Self-clearing
+};  // of struct inaTraits3221
+/*! Traits of the first INA3221 channel */
+template <>
+struct inaTraits<INA3221_0> : inaTraits3221<0> {};
+/*! Traits of the second INA3221 channel */
+template <>
+struct inaTraits<INA3221_1> : inaTraits3221<1> {};
+/*! Traits of the third INA3221 channel */
+template <>
+struct inaTraits<INA3221_2> : inaTraits3221<2> {};
+
+inline INA_Transport& inaWireTransport() {
+  /*! @brief   Returns the transport on "Wire" which "INA_Device" instances use by default
+      @return  Shared "INA_WireTransport" attached to "Wire" */
+  static INA_WireTransport transport(&Wire);
+  return (transport);
+}  // of function inaWireTransport()
+
+template <ina_Type TYPE, uint8_t ADDRESS, uint16_t MAX_AMPS, uint32_t MICRO_OHM>
+class INA_Device {
+  /*!
+   * @class   INA_Device
+   * @brief   Statically configured driver for a single INA device
+   * @details All values which "INA_Class" decodes at runtime are compile-time constants here, so
+   *          every method compiles to the register accesses of the selected device type only. The
+   *          getters do not restart conversions in triggered mode, call "triggerConversion()"
+   *          after reading. An INA3221 is addressed one channel per instance, "reset()" and
+   *          "setMode()" on any channel act on the whole chip
+   */
+  typedef inaTraits<TYPE> traits;  ///< Register definitions of the device type
+  static_assert(ADDRESS >= 0x40 && ADDRESS <= 0x4F, "INA devices use I2C addresses 0x40 - 0x4F");
+  static_assert(traits::fixedLSB || !traits::hasCurrent || MAX_AMPS != 0,
+                "Maximum amps must be specified for this device type");
+  static_assert(traits::hasCurrent || MICRO_OHM != 0, "Shunt resistance must be specified");
+
+ public:
+  /*! Current LSB in nA, either fixed by the device or the best possible for MAX_AMPS */
+  static constexpr uint32_t currentLSB{traits::fixedLSB
+                                           ? traits::fixedLSB
+                                           : (uint32_t)((uint64_t)MAX_AMPS * 1000000000 / 32767)};
+  /*! Power LSB in nW */
+  static constexpr uint32_t powerLSB{traits::powerMult * currentLSB};
+  /*! Divisor used to compute the calibration register */
+  static constexpr uint64_t calibrationDivisor{(uint64_t)currentLSB * MICRO_OHM / 100000};
+  /*! Contents of the calibration register, 0 if the device has none */
+  static constexpr uint16_t calibration{(traits::calFactor && calibrationDivisor)
+                                            ? traits::calFactor / calibrationDivisor
+                                            : 0};
+  explicit INA_Device(INA_Transport& bus = inaWireTransport(), const uint8_t i2cDelay = I2C_DELAY)
+      : _bus(&bus), _i2cDelay(i2cDelay) {
+    /*! @brief     Class constructor, attaches the device to a bus
+        @param[in] bus Transport the device is connected to, "Wire" by default
+        @param[in] i2cDelay Microseconds to wait after register pointer and data writes, see
+                   "setI2CSpeed()" in "INA_Class" */
+  }  // of constructor
+  void begin() const {
+    /*! @brief   Resets the device and writes the calibration and, on an INA219, gain settings */
+    reset();
+    if (traits::calFactor) writeWord(INA_CALIBRATION_REGISTER, calibration);
+    if (TYPE == INA219) {
+      /* Determine the smallest programmable gain which avoids an overflow, 0-32V bus range */
+      const uint32_t maxShuntmV = (uint32_t)MAX_AMPS * MICRO_OHM / 1000;
+      uint16_t       configRegister = 0x399F & INA219_CONFIG_PG_MASK;  // Zero programmable gain
+      configRegister |= (maxShuntmV <= 40 ? 0 : maxShuntmV <= 80 ? 1 : maxShuntmV <= 160 ? 2 : 3)
+                        << INA219_PG_FIRST_BIT;
+      bitSet(configRegister, INA219_BRNG_BIT);  // set to 1 for 0-32 volts
+      writeWord(INA_CONFIGURATION_REGISTER, configRegister);
+    }  // of if-then an INA219
+  }    // of method begin()
+  void reset() const {
+    /*! @brief   Resets the device to its power-on defaults */
+    writeWord(INA_CONFIGURATION_REGISTER, INA_RESET_DEVICE);
+  }  // of method reset()
+  void setMode(const uint8_t mode) const {
+    /*! @brief     Sets the operating mode, see the "INA_MODE_..." constants in "INA.h"
+        @param[in] mode Operating mode, only the 3 LSB are used */
+    writeWord(INA_CONFIGURATION_REGISTER,
+              (readWord(INA_CONFIGURATION_REGISTER) & ~(uint16_t)B111) | (mode & B111));
+  }  // of method setMode()
+  void triggerConversion() const {
+    /*! @brief   Starts the next conversion when the device is in triggered mode */
+    writeWord(INA_CONFIGURATION_REGISTER, readWord(INA_CONFIGURATION_REGISTER));
+  }  // of method triggerConversion()
+  bool conversionFinished() const {
+    /*! @brief   Returns whether a conversion has finished, reading the flag resets it
+        @return  "true" when a conversion has finished */
+    bool ready = (readWord(traits::readyReg) & traits::readyMask) != 0;
+    if (traits::readyClear) readWord(INA_POWER_REGISTER);  // Resets the "ready" bit
+    return (ready);
+  }  // of method conversionFinished()
+  uint16_t getBusRaw() const {
+    /*! @brief   Returns the raw bus voltage register, right-aligned
+        @return  Raw bus measurement */
+    return ((uint16_t)readWord(traits::busReg) >> traits::busShift);
+  }  // of method getBusRaw()
+  int16_t getShuntRaw() const {
+    /*! @brief   Returns the raw shunt voltage register, right-aligned and sign-extended
+        @return  Raw shunt measurement, 0 on the INA260 which has no shunt register */
+    return (traits::hasShunt ? readWord(traits::shuntReg) >> traits::shuntShift : 0);
+  }  // of method getShuntRaw()
+  uint16_t getBusMilliVolts() const {
+    /*! @brief   Returns the bus voltage in millivolts
+        @return  Bus millivolts */
+    return ((uint32_t)getBusRaw() * traits::busLSB / 100);
+  }  // of method getBusMilliVolts()
+  int32_t getShuntMicroVolts() const {
+    /*! @brief   Returns the shunt voltage in microvolts
+        @details The INA260 has no shunt register, the value is computed from its 2mOhm shunt
+        @return  Shunt microvolts */
+    if (!traits::hasShunt) return (getBusMicroAmps() / 200);  // 2mOhm resistor, Ohm's law
+    return ((int32_t)getShuntRaw() * traits::shuntLSB / 10);
+  }  // of method getShuntMicroVolts()
+  int32_t getBusMicroAmps() const {
+    /*! @brief   Returns the bus current in microamps
+        @details The INA3221 has no current register, the value is computed from the shunt
+        @return  Microamps */
+    if (!traits::hasCurrent) {
+      return ((int64_t)getShuntRaw() * traits::shuntLSB * 100000 / (int64_t)MICRO_OHM);
+    }  // of if-then no current register
+    return ((int64_t)readWord(traits::currentReg) * (int64_t)currentLSB / 1000);
+  }  // of method getBusMicroAmps()
+  int64_t getBusMicroWatts() const {
+    /*! @brief   Returns the bus power in microwatts
+        @details The power register is unsigned, the sign is taken from the current register
+        @return  Microwatts */
+    if (!traits::hasCurrent) {
+      return ((int64_t)getBusMicroAmps() * (int64_t)getBusMilliVolts() / 1000);
+    }  // of if-then no power register
+    int64_t microWatts = (int64_t)(uint16_t)readWord(INA_POWER_REGISTER) * powerLSB / 1000;
+    if (readWord(traits::currentReg) < 0) microWatts = -microWatts;  // Issue #87
+    return (microWatts);
+  }  // of method getBusMicroWatts()
+
+ private:
+  int16_t readWord(const uint8_t addr) const {
+    /*! @brief     Read one word (2 bytes) from a register of the device
+        @param[in] addr Register to read
+        @return    Register contents */
+    _bus->beginTransmission(ADDRESS);        // Address the I2C device
+    _bus->write(addr);                       // Send register address to read
+    _bus->endTransmission();                 // Close transmission
+    delayMicroseconds(_i2cDelay);            // delay required for sync
+    _bus->requestFrom(ADDRESS, (uint8_t)2);  // Request 2 consecutive bytes
+    const uint8_t msb = _bus->read();        // Sequence the reads, the MSB comes first
+    return ((uint16_t)msb << 8) | (uint8_t)_bus->read();
+  }  // of method readWord()
+  void writeWord(const uint8_t addr, const uint16_t data) const {
+    /*! @brief     Write one word (2 bytes) to a register of the device
+        @param[in] addr Register to write
+        @param[in] data Value to write */
+    _bus->beginTransmission(ADDRESS);   // Address the I2C device
+    _bus->write(addr);                  // Send register address to write
+    _bus->write((uint8_t)(data >> 8));  // Write the first (MSB) byte
+    _bus->write((uint8_t)data);         // and then the second byte
+    _bus->endTransmission();            // Close transmission and actually send data
+    delayMicroseconds(_i2cDelay);       // delay required for sync
+  }  // of method writeWord()
+  INA_Transport* _bus;       ///< Bus the device is connected to
+  uint8_t        _i2cDelay;  ///< Microseconds to wait after pointer/data writes
+};   // of INA_Device class definition
+#endif
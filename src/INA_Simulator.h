@@ -0,0 +1,428 @@
+// clang-format off
+/*!
+ @file INA_Simulator.h
+
+ @brief Simulated INA devices, an I2C transport which needs no hardware
+
+ @section INA_Simulator_intro_section Description
+
+ The "INA_Simulator" template is an "INA_Transport" which answers the I2C traffic of the library
+ with a register model of INA219, INA226, INA228, INA260 and INA3221 devices. The register
+ pointer, the reset and calibration registers, the conversion-ready flags and the triggered and
+ continuous modes behave as described in the data sheets. The bus and shunt voltages each device
+ measures are set by the program, the shunt, bus, current and power registers are then derived
+ from them, so the library can be run, benchmarked and checked for regressions on any board, or on
+ a host computer with an Arduino core emulation, without any INA device attached. For example:\n\n
+
+ INA_Simulator<2> simulator;\n
+ simulator.addDevice(0x40, INA226);\n
+ simulator.setReading(0x40, 12000000, 2500000);  // 12V bus, 2.5mV over the shunt\n
+ INA.setTransport(simulator);\n
+ INA.begin(1, 100000);\n\n
+
+ Conversions complete instantly, a triggered conversion as soon as it is started and in continuous
+ mode whenever the device is read. The alert limits are stored but never trip and the INA228
+ energy and charge registers read as 0. A degraded bus can be simulated with "failTransfers()" and
+ the register contents can be checked with "getRegister()".
+
+ See "INA.h" for the license and author information.
+
+@section INA_Simulator_versions Changelog
+
+| Version | Date       | Developer   | Comments
+| ------- | ---------- | ----------- | --------
+| 1.2.0   | 2026-10-15 | agent       | Separate INA228 SOVL and SUVL registers
+| 1.2.0   | 2026-10-15 | agent       | getRegister() to check the registers from a test
+| 1.2.0   | 2026-10-14 | agent       | Simulated bus errors with failTransfers()
+| 1.2.0   | 2026-10-14 | agent       | Initial coding
+*/
+// clang-format on
+#ifndef INA__Simulator_h
+/*! Guard code definition to prevent multiple includes */
+#define INA__Simulator_h
+#include <INA.h>  // Transport interface, register constants and device types
+
+/*! typedef contains the register model of one simulated device, see "INA_Simulator" */
+typedef struct {
+  uint8_t  address;            ///< I2C address
+  uint8_t  type;               ///< Device type, INA3221_0 for an INA3221
+  uint8_t  pointer;            ///< Register pointer
+  bool     ready;              ///< Conversion ready flag
+  uint16_t config;             ///< Configuration register
+  uint16_t adcConfig;          ///< INA228 ADC configuration register
+  uint16_t calibration;        ///< Calibration register, SHUNT_CAL on the INA228
+  uint16_t mask;               ///< Mask/enable register, DIAG_ALRT on the INA228, without flags
+  uint16_t limit;              ///< Alert limit register, the other limits on the INA228
+  uint16_t shuntLimits[2];     ///< INA228 SOVL and SUVL registers
+  uint32_t busMicroVolts[3];   ///< Bus voltage measured by each channel
+  int32_t  shuntNanoVolts[3];  ///< Shunt voltage measured by each channel
+  uint32_t busRaw[3];          ///< Bus reading of the last conversion, right-aligned
+  int32_t  shuntRaw[3];        ///< Shunt reading of the last conversion, right-aligned
+} inaSimDevice;                // of structure
+
+template <uint8_t DEVICES = 4>
+class INA_Simulator : public INA_Transport {
+  /*!
+   * @class   INA_Simulator
+   * @brief   Register model of up to DEVICES INA devices behind one simulated I2C bus
+   */
+  static_assert(DEVICES != 0, "INA_Simulator needs room for at least one device");
+ public:
+  bool addDevice(const uint8_t address, const uint8_t type) {
+    /*! @brief     Attach a simulated device to the bus, in the state it has after power-up
+        @param[in] address I2C address, 0x40 - 0x4F
+        @param[in] type INA219, INA226, INA228, INA260 or INA3221_0, from the "ina_Type" list
+        @return    "true" on success, "false" if the bus is full, the address is taken or the type
+                   isn't simulated */
+    if (_count >= DEVICES || find(address) != nullptr) return (false);
+    if (type != INA219 && type != INA226 && type != INA228 && type != INA260 &&
+        type != INA3221_0) {
+      return (false);
+    }  // of if-then not a simulated type
+    inaSimDevice &device = _devices[_count++];
+    device.address       = address;
+    device.type          = type;
+    device.pointer       = 0;
+    for (uint8_t ch = 0; ch < 3; ch++) {
+      device.busMicroVolts[ch]  = 0;
+      device.shuntNanoVolts[ch] = 0;
+      device.busRaw[ch]         = 0;
+      device.shuntRaw[ch]       = 0;
+    }  // of for-next each channel
+    resetDevice(device);
+    return (true);
+  }  // of method addDevice()
+  bool setReading(const uint8_t address, const uint32_t busMicroVolts,
+                  const int32_t shuntNanoVolts, const uint8_t channel = 0) {
+    /*! @brief     Set the voltages a simulated device measures from its next conversion on
+        @details   The INA260 measures the current through its internal 2 milli-Ohm shunt, so the
+                   shunt voltage is the current in milliamps times 2000
+        @param[in] address I2C address of the device
+        @param[in] busMicroVolts Bus voltage in microvolts
+        @param[in] shuntNanoVolts Shunt voltage in nanovolts
+        @param[in] channel [optional] Channel 0 - 2 of an INA3221
+        @return    "true" on success, "false" for an unknown device or channel */
+    inaSimDevice *device = find(address);
+    if (device == nullptr || channel >= channels(*device)) return (false);
+    device->busMicroVolts[channel]  = busMicroVolts;
+    device->shuntNanoVolts[channel] = shuntNanoVolts;
+    return (true);
+  }  // of method setReading()
+  uint64_t getRegister(const uint8_t address, const uint8_t reg) {
+    /*! @brief     Return the contents of a register without the side effects of a read
+        @details   The register pointer, the readings and the conversion-ready flag are left as they
+                   are, so a test can check the settings the library wrote to a device
+        @param[in] address I2C address of the device
+        @param[in] reg Register address
+        @return    Register contents, right-aligned, 0 for an unknown device */
+    inaSimDevice *device = find(address);
+    uint64_t      value  = 0;
+    if (device != nullptr) registerValue(*device, reg, value);
+    return (value);
+  }  // of method getRegister()
+  uint8_t devices() const {
+    /*! @brief     Return the number of simulated devices
+        @return    Number of devices added with "addDevice()" */
+    return (_count);
+  }  // of method devices()
+  void failTransfers(const uint8_t count) {
+    /*! @brief     Make the next transfers to the simulated devices fail as on a noisy bus
+        @details   Each write is then not acknowledged and each read returns no bytes, without
+                   changing the register model. Transfers to addresses without a device fail
+                   anyway and aren't counted
+        @param[in] count Number of transfers to fail, 0 to stop failing them */
+    _failures = count;
+  }  // of method failTransfers()
+  void beginTransmission(const uint8_t address) override {
+    /*! @brief     Start collecting the bytes of a write to a device
+        @param[in] address I2C address of the device */
+    _txAddress = address;
+    _txCount   = 0;
+  }  // of method beginTransmission()
+  uint8_t write(const uint8_t data) override {
+    /*! @brief     Queue a byte, the devices only use the register pointer and one 16-bit value
+        @param[in] data Byte to write
+        @return    Number of bytes queued */
+    if (_txCount >= sizeof(_tx)) return (0);
+    _tx[_txCount++] = data;
+    return (1);
+  }  // of method write()
+  uint8_t endTransmission(const bool sendStop = true) override {
+    /*! @brief     Apply the write, the first byte sets the pointer and the next two are written to
+                   the register it points at
+        @param[in] sendStop Ignored, the simulated bus is never held by another master
+        @return    0 on success, 2 if no device has the address or the transfer failed */
+    (void)sendStop;
+    inaSimDevice *device = find(_txAddress);
+    if (device == nullptr) return (2);  // Address not acknowledged
+    if (_failures) {
+      _failures--;
+      return (2);
+    }  // of if-then simulated bus error
+    if (_txCount) device->pointer = _tx[0];
+    if (_txCount == 3) writeRegister(*device, _tx[0], (uint16_t)_tx[1] << 8 | _tx[2]);
+    return (0);
+  }  // of method endTransmission()
+  uint8_t requestFrom(const uint8_t address, const uint8_t count) override {
+    /*! @brief     Read the register the device points at, most significant byte first
+        @param[in] address I2C address of the device
+        @param[in] count Number of bytes to read, bytes beyond the register width read as 0
+        @return    Number of bytes received, 0 if no device has the address or on failure */
+    _rxCount = 0;
+    _rxNext  = 0;
+    inaSimDevice *device = find(address);
+    if (device == nullptr) return (0);
+    if (_failures) {
+      _failures--;
+      return (0);
+    }  // of if-then simulated bus error
+    if (isContinuous(*device)) convert(*device);  // Always a fresh result in continuous mode
+    uint64_t value;
+    uint8_t  width = registerValue(*device, device->pointer, value);
+    _rxCount       = count < sizeof(_rx) ? count : sizeof(_rx);
+    for (uint8_t i = 0; i < _rxCount; i++) {
+      _rx[i] = i < width ? (uint8_t)(value >> (8 * (width - 1 - i))) : 0;
+    }  // of for-next each byte
+    clearReady(*device, device->pointer);
+    return (_rxCount);
+  }  // of method requestFrom()
+  int read() override {
+    /*! @brief     Return the next byte of the last "requestFrom()"
+        @return    Byte read, -1 if there is none */
+    return (_rxNext < _rxCount ? _rx[_rxNext++] : -1);
+  }  // of method read()
+ private:
+  inaSimDevice *find(const uint8_t address) {
+    /*! @brief     Return the device with the given address
+        @param[in] address I2C address
+        @return    Pointer to the device, nullptr if there is none */
+    for (uint8_t i = 0; i < _count; i++) {
+      if (_devices[i].address == address) return (&_devices[i]);
+    }  // of for-next each device
+    return (nullptr);
+  }  // of method find()
+  uint8_t channels(const inaSimDevice &device) const {
+    /*! @brief     Return the number of channels of a device
+        @param[in] device Simulated device
+        @return    3 for an INA3221, otherwise 1 */
+    return (device.type == INA3221_0 ? 3 : 1);
+  }  // of method channels()
+  void resetDevice(inaSimDevice &device) const {
+    /*! @brief     Put the registers into their power-on state, as a reset through the
+                   configuration register does
+        @param[in] device Simulated device */
+    device.ready          = false;
+    device.adcConfig      = 0xFB68;  // INA228 continuous, longest conversions, no averaging
+    device.calibration    = device.type == INA228 ? 0x1000 : 0;
+    device.mask           = 0;
+    device.limit          = 0;
+    device.shuntLimits[0] = 0x7FFF;  // SOVL and SUVL start at the ends of the range
+    device.shuntLimits[1] = 0x8000;
+    switch (device.type) {
+      case INA219: device.config = 0x399F; break;
+      case INA226: device.config = 0x4127; break;
+      case INA260: device.config = 0x6127; break;
+      case INA3221_0: device.config = 0x7127; break;
+      default: device.config = 0;  // INA228
+    }  // of switch type
+  }  // of method resetDevice()
+  bool isContinuous(const inaSimDevice &device) const {
+    /*! @brief     Return whether a device is converting continuously
+        @param[in] device Simulated device
+        @return    "true" in one of the continuous modes */
+    if (device.type == INA228) return ((device.adcConfig & 0x8000) && (device.adcConfig & 0x7000));
+    return ((device.config & 4) && (device.config & 3));
+  }  // of method isContinuous()
+  bool isTriggered(const inaSimDevice &device) const {
+    /*! @brief     Return whether a device is in one of the triggered modes
+        @param[in] device Simulated device
+        @return    "true" in one of the triggered modes */
+    if (device.type == INA228) return (!(device.adcConfig & 0x8000) && (device.adcConfig & 0x7000));
+    return (!(device.config & 4) && (device.config & 3));
+  }  // of method isTriggered()
+  int32_t clamp(const int64_t value, const int32_t minimum, const int32_t maximum) const {
+    /*! @brief     Limit a reading to the range of its register
+        @param[in] value Reading
+        @param[in] minimum Lowest value the register holds
+        @param[in] maximum Highest value the register holds
+        @return    Clamped reading */
+    return (value < minimum ? minimum : value > maximum ? maximum : (int32_t)value);
+  }  // of method clamp()
+  void convert(inaSimDevice &device) const {
+    /*! @brief     Do a conversion, the voltages set by "setReading()" become the register readings
+        @param[in] device Simulated device */
+    for (uint8_t ch = 0; ch < channels(device); ch++) {
+      int64_t bus   = device.busMicroVolts[ch];
+      int64_t shunt = device.shuntNanoVolts[ch];
+      switch (device.type) {
+        case INA219:  // 4mV bus LSB, 10uV shunt LSB
+          device.busRaw[ch]   = clamp(bus / 4000, 0, 8191);
+          device.shuntRaw[ch] = clamp(shunt / 10000, -32000, 32000);
+          break;
+        case INA226:  // 1.25mV bus LSB, 2.5uV shunt LSB
+        case INA260:  // 1.25mV bus LSB, 1.25mA current LSB is 2.5uV over the 2mOhm shunt
+          device.busRaw[ch]   = clamp(bus / 1250, 0, 32767);
+          device.shuntRaw[ch] = clamp(shunt / 2500, -32768, 32767);
+          break;
+        case INA228:  // 195.3125uV bus LSB, 312.5nV or 78.125nV shunt LSB
+          if (bitRead(device.config, INA228_ADCRANGE_BIT)) shunt = shunt * 4;  // Finer range
+          device.busRaw[ch]   = clamp(bus * 16 / 3125, 0, 524287);
+          device.shuntRaw[ch] = clamp(shunt * 10 / 3125, -524288, 524287);
+          break;
+        default:  // INA3221, 8mV bus LSB, 40uV shunt LSB
+          device.busRaw[ch]   = clamp(bus / 8000, 0, 4095);
+          device.shuntRaw[ch] = clamp(shunt / 40000, -4096, 4095);
+      }  // of switch type
+    }    // of for-next each channel
+    device.ready = true;
+  }  // of method convert()
+  void writeRegister(inaSimDevice &device, const uint8_t reg, const uint16_t value) const {
+    /*! @brief     Write a register, a write to the configuration register can reset the device or
+                   start a triggered conversion
+        @param[in] device Simulated device
+        @param[in] reg Register address
+        @param[in] value Value written */
+    bool configured = false;
+    if (reg == INA_CONFIGURATION_REGISTER) {
+      if (value & INA_RESET_DEVICE) {
+        resetDevice(device);
+        return;
+      }  // of if-then reset
+      device.config = device.type == INA228 ? value & ~INA228_RESET_ACCUMULATORS : value;
+      configured    = device.type != INA228;
+    } else if (device.type == INA228) {
+      switch (reg) {
+        case INA228_ADC_CONFIG_REGISTER:
+          device.adcConfig = value;
+          configured       = true;
+          break;
+        case INA228_SHUNT_CAL_REGISTER: device.calibration = value & 0x7FFF; break;
+        case INA228_DIAG_ALERT_REGISTER: device.mask = value & 0xF000; break;  // Control bits
+        case INA228_SHUNT_OVER_REGISTER: device.shuntLimits[0] = value; break;
+        case INA228_SHUNT_UNDER_REGISTER: device.shuntLimits[1] = value; break;
+        default: device.limit = value;  // The other limit registers share this simple model
+      }  // of switch register
+    } else if (device.type == INA3221_0) {
+      if (reg == INA3221_MASK_REGISTER) device.mask = value & 0x7C00;  // Control bits
+      else device.limit = value;
+    } else {
+      switch (reg) {
+        case INA_CALIBRATION_REGISTER: device.calibration = value; break;
+        case INA_MASK_ENABLE_REGISTER: device.mask = value & 0xFC03; break;  // Control bits
+        case INA_ALERT_LIMIT_REGISTER: device.limit = value; break;
+      }  // of switch register
+    }    // of if-then-else register type
+    if (configured) {
+      device.ready = false;
+      if (isTriggered(device)) convert(device);  // Writing the mode starts a conversion
+    }  // of if-then mode written
+  }  // of method writeRegister()
+  uint8_t registerValue(const inaSimDevice &device, const uint8_t reg, uint64_t &value) const {
+    /*! @brief     Return the contents of a register
+        @param[in] device Simulated device
+        @param[in] reg Register address
+        @param[out] value Register contents, right-aligned
+        @return    Register width in bytes */
+    value = 0;
+    if (device.type == INA228) {
+      int32_t current = 0;  // No current until SHUNT_CAL is written
+      if (device.calibration) {
+        current = clamp(device.shuntRaw[0] * 4096LL / device.calibration, -524288, 524287);
+      }  // of if-then calibrated
+      switch (reg) {
+        case INA_CONFIGURATION_REGISTER: value = device.config; break;
+        case INA228_ADC_CONFIG_REGISTER: value = device.adcConfig; break;
+        case INA228_SHUNT_CAL_REGISTER: value = device.calibration; break;
+        case INA228_SHUNT_VOLTAGE_REGISTER:
+          value = ((uint32_t)device.shuntRaw[0] << 4) & 0xFFFFFF;
+          return (3);
+        case INA228_BUS_VOLTAGE_REGISTER: value = device.busRaw[0] << 4; return (3);
+        case 0x06: value = 0x0C80; break;  // DIETEMP, 25 degrees
+        case INA228_CURRENT_REGISTER: value = ((uint32_t)current << 4) & 0xFFFFFF; return (3);
+        case INA228_POWER_REGISTER:
+          value = (uint64_t)(current < 0 ? -current : current) * device.busRaw[0] / 16384;
+          return (3);
+        case INA228_ENERGY_REGISTER:
+        case INA228_CHARGE_REGISTER: return (5);
+        case INA228_DIAG_ALERT_REGISTER:
+          value = device.mask | (device.ready ? INA228_CONV_READY_MASK : 0);
+          break;
+        case 0x3E: value = 0x5449; break;  // Manufacturer ID, "TI"
+        case INA228_DIE_ID_REGISTER: value = INA228_DIE_ID_VALUE | 1; break;
+        case INA228_SHUNT_OVER_REGISTER: value = device.shuntLimits[0]; break;
+        case INA228_SHUNT_UNDER_REGISTER: value = device.shuntLimits[1]; break;
+        default: value = device.limit;
+      }  // of switch register
+      return (2);
+    }  // of if-then INA228
+    if (reg == INA_CONFIGURATION_REGISTER) {
+      value = device.config;
+    } else if (reg == INA_MANUFACTURER_ID_REGISTER) {
+      value = 0x5449;  // "TI"
+    } else if (device.type == INA3221_0) {
+      if (reg >= 1 && reg <= 6) {  // Shunt and bus of each channel, 3 LSB unused
+        uint8_t ch = (reg - 1) / 2;
+        value      = (reg & 1) ? (uint16_t)(device.shuntRaw[ch] << 3) : device.busRaw[ch] << 3;
+      } else if (reg == INA3221_MASK_REGISTER) {
+        value = device.mask | (device.ready ? 1 : 0);
+      } else if (reg == INA_DIE_ID_REGISTER) {
+        value = 0x3220;
+      } else {
+        value = device.limit;
+      }  // of if-then-else register
+    } else {
+      int32_t  shunt = device.shuntRaw[0];
+      uint32_t bus   = device.busRaw[0];
+      int32_t  current;
+      uint32_t power;
+      if (device.type == INA219) {
+        current = (int16_t)(shunt * (int32_t)device.calibration / 4096);
+        power   = (uint32_t)(current < 0 ? -current : current) * bus / 5000;
+      } else if (device.type == INA226) {
+        current = (int16_t)(shunt * (int32_t)device.calibration / 2048);
+        power   = (uint32_t)(current < 0 ? -current : current) * bus / 20000;
+      } else {  // INA260, the shunt reading is the current
+        current = shunt;
+        power   = (uint32_t)(current < 0 ? -current : current) * bus / 6400;
+      }  // of if-then-else type
+      switch (reg) {
+        case 1: value = (uint16_t)(device.type == INA260 ? current : shunt); break;
+        case INA_BUS_VOLTAGE_REGISTER:
+          value = device.type == INA219 ? bus << 3 | (device.ready ? 2 : 0) : bus;
+          break;
+        case INA_POWER_REGISTER: value = power > 0xFFFF ? 0xFFFF : power; break;
+        case 4: value = device.type == INA260 ? 0 : (uint16_t)current; break;
+        case INA_CALIBRATION_REGISTER: value = device.calibration; break;
+        case INA_MASK_ENABLE_REGISTER:
+          value = device.mask | (device.ready ? INA_CONVERSION_READY_FLAG : 0);
+          break;
+        case INA_ALERT_LIMIT_REGISTER: value = device.limit; break;
+        case INA_DIE_ID_REGISTER:
+          value = device.type == INA226 ? INA226_DIE_ID_VALUE : device.type == INA260 ? 0x2270 : 0;
+          break;
+      }  // of switch register
+    }    // of if-then-else type
+    return (2);
+  }  // of method registerValue()
+  void clearReady(inaSimDevice &device, const uint8_t reg) const {
+    /*! @brief     Clear the conversion-ready flag if reading the register does so on the device
+        @param[in] device Simulated device
+        @param[in] reg Register just read */
+    switch (device.type) {
+      case INA219: if (reg == INA_POWER_REGISTER) device.ready = false; break;
+      case INA228: if (reg == INA228_DIAG_ALERT_REGISTER) device.ready = false; break;
+      case INA3221_0: if (reg == INA3221_MASK_REGISTER) device.ready = false; break;
+      default: if (reg == INA_MASK_ENABLE_REGISTER) device.ready = false;
+    }  // of switch type
+  }  // of method clearReady()
+  inaSimDevice _devices[DEVICES];  ///< Simulated devices
+  uint8_t      _count{0};          ///< Number of devices added
+  uint8_t      _txAddress{0};      ///< Address of the write being collected
+  uint8_t      _tx[3];             ///< Bytes of the write being collected
+  uint8_t      _txCount{0};        ///< Number of bytes collected
+  uint8_t      _rx[8];             ///< Bytes of the last read
+  uint8_t      _rxCount{0};        ///< Number of bytes read
+  uint8_t      _rxNext{0};         ///< Next byte "read()" returns
+  uint8_t      _failures{0};       ///< Transfers still to fail, see failTransfers()
+};  // of INA_Simulator class definition
+#endif